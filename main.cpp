@@ -38,20 +38,9 @@ void HONoInt(vmcp::StatFuncType statFunction) {
         Masses<N> m;
         FPType omegaHO;
         FPType gamma;
-        FPType operator()(Positions<D, N> x) const {
-            Coordinate *begin = &x[0][0];
-            Coordinate *end = &x[0][0] + N * D;
-            FPType result =
-                std::transform_reduce(begin, end, FPType{0.f}, std::plus<>(),
-                                      [D_ = D, gamma_ = gamma, &begin](Coordinate &c) {
-                                          // Compute the index of the current element
-                                          auto const index = &c - begin;
-                                          // Check if it is in the last dimension
-                                          bool isLastDimension =
-                                              ((static_cast<UIntType>(index) + 1u) % D_ == 0) && (D_ != 1);
-                                          return c.val * c.val * (isLastDimension ? gamma_ * gamma_ : 1);
-                                      }) *
-                m[0].val * omegaHO * omegaHO / 2;
+        FPType operator()(Positions<D, N> const &x) const {
+            FPType result = WeightedSquaredNorm<D, N>(x, LastAxisWeights<D>(gamma * gamma)) * m[0].val *
+                            omegaHO * omegaHO / 2;
             assert(!std::isnan(result));
 
             return result;
@@ -60,17 +49,9 @@ void HONoInt(vmcp::StatFuncType statFunction) {
     struct WavefHO {
         FPType alpha;
         FPType beta;
-        FPType operator()(Positions<D, N> x, VarParams<0>) const {
+        FPType operator()(Positions<D, N> const &x, VarParams<0>) const {
             //   Harmonic oscillator term
-            Coordinate *begin = &x[0][0];
-            Coordinate *end = &x[0][0] + N * D;
-
-            FPType expArg = std::transform_reduce(
-                begin, end, FPType{0}, std::plus<>(), [beta_ = beta, &begin](Coordinate &c) {
-                    auto const index = &c - begin;
-                    bool isLastDimension = ((static_cast<UIntType>(index) + 1u) % D == 0) && (D != 1);
-                    return c.val * c.val * (isLastDimension ? beta_ : 1);
-                });
+            FPType const expArg = WeightedSquaredNorm<D, N>(x, LastAxisWeights<D>(beta));
 
             return std::exp(-alpha * expArg);
         }
@@ -87,7 +68,7 @@ void HONoInt(vmcp::StatFuncType statFunction) {
         }
         FirstDerHO() : alpha{}, beta{}, dimension{}, particle{} {}
 
-        FPType operator()(Positions<D, N> x, VarParams<0>) const {
+        FPType operator()(Positions<D, N> const &x, VarParams<0>) const {
             // Harmonic oscillator first derivative term
             FPType result = -2 * alpha * x[particle][dimension].val *
                             (((dimension == (D - 1)) && (D != 1)) ? beta : 1) *
@@ -108,23 +89,10 @@ void HONoInt(vmcp::StatFuncType statFunction) {
         }
         LaplHO() : alpha{}, beta{}, particle{} {}
 
-        FPType operator()(Positions<D, N> x, VarParams<0>) const {
-            UIntType uPar = particle;
-            Coordinate *begin = &x[uPar][0];
-            Coordinate *end = &x[uPar][0] + D;
-
+        FPType operator()(Positions<D, N> const &x, VarParams<0>) const {
             FPType result =
                 (std::pow(2 * alpha, 2) *
-                     std::transform_reduce(begin, end, FPType{0.f}, std::plus<>(),
-                                           [D_ = D, beta_ = beta, &begin](Coordinate &c) {
-                                               // Compute the index of the current element
-                                               auto const index = &c - begin;
-                                               // Check if it is in the last dimension
-                                               bool isLastDimension =
-                                                   ((static_cast<UIntType>(index) + 1u) % D_ == 0) &&
-                                                   (D_ != 1);
-                                               return c.val * c.val * (isLastDimension ? beta_ * beta_ : 1);
-                                           }) -
+                     WeightedSquaredNorm<D>(x[particle], LastAxisWeights<D>(beta * beta)) -
                  2 * alpha * ((D == 1) ? 1 : (D - 1 + beta))) *
                 WavefHO{alpha, beta}(x, VarParams<0>{});
             assert(!std::isnan(result));
@@ -344,16 +312,8 @@ void HONoInt(vmcp::StatFuncType statFunction) {
     // Structs with alpha as variational parameter to then find best alpha value via grandient descent
     struct WavefHOVar {
         FPType beta;
-        FPType operator()(Positions<D, N> x, VarParams<1> alpha) const {
-            Coordinate *begin = &x[0][0];
-            Coordinate *end = &x[0][0] + N * D;
-
-            FPType expArg = std::transform_reduce(
-                begin, end, FPType{0}, std::plus<>(), [beta_ = beta, &begin](Coordinate &c) {
-                    auto const index = &c - begin;
-                    bool isLastDimension = ((static_cast<UIntType>(index) + 1u) % D == 0) && (D != 1);
-                    return c.val * c.val * (isLastDimension ? beta_ : 1);
-                });
+        FPType operator()(Positions<D, N> const &x, VarParams<1> alpha) const {
+            FPType const expArg = WeightedSquaredNorm<D, N>(x, LastAxisWeights<D>(beta));
 
             return std::exp(-alpha[0].val * expArg);
         }
@@ -369,7 +329,7 @@ void HONoInt(vmcp::StatFuncType statFunction) {
         }
         FirstDerHOVar() : beta{}, dimension{}, particle{} {}
 
-        FPType operator()(Positions<D, N> x, VarParams<1> alpha) const {
+        FPType operator()(Positions<D, N> const &x, VarParams<1> alpha) const {
             FPType result = -2 * alpha[0].val * x[particle][dimension].val *
                             (((dimension == (D - 1)) && (D != 1)) ? beta : 1) * WavefHOVar{beta}(x, {alpha});
             assert(!std::isnan(result));
@@ -386,23 +346,10 @@ void HONoInt(vmcp::StatFuncType statFunction) {
         }
         LaplHOVar() : beta{}, particle{} {}
 
-        FPType operator()(Positions<D, N> x, VarParams<1> alpha) const {
-            UIntType uPar = particle;
-            Coordinate *begin = &x[uPar][0];
-            Coordinate *end = &x[uPar][0] + D;
-
+        FPType operator()(Positions<D, N> const &x, VarParams<1> alpha) const {
             FPType result =
                 (std::pow(2 * alpha[0].val, 2) *
-                     std::transform_reduce(begin, end, FPType{0.f}, std::plus<>(),
-                                           [D_ = D, beta_ = beta, &begin](Coordinate &c) {
-                                               // Compute the index of the current element
-                                               auto const index = &c - begin;
-                                               // Check if it is in the last dimension
-                                               bool isLastDimension =
-                                                   ((static_cast<UIntType>(index) + 1u) % D_ == 0) &&
-                                                   (D_ != 1);
-                                               return c.val * c.val * (isLastDimension ? beta_ * beta_ : 1);
-                                           }) -
+                     WeightedSquaredNorm<D>(x[particle], LastAxisWeights<D>(beta * beta)) -
                  2 * alpha[0].val * ((D == 1) ? 1 : (D - 1 + beta))) *
                 WavefHOVar{beta}(x, {alpha});
             assert(!std::isnan(result));
@@ -520,144 +467,108 @@ void HOInt(vmcp::StatFuncType statFunction, std::vector<vmcp::FPType> &energyVal
     assert(N != 1);
     CoordBounds<D> const coordBounds = MakeCoordBounds<D>(Coordinate{-10}, Coordinate{10});
 
-    struct PotHO {
-        Masses<N> m;
+    // The trap acts on each particle separately, so the potential can be tracked incrementally
+    struct TrapHO {
+        Mass m;
         FPType omegaHO;
         FPType gamma;
-        FPType operator()(Positions<D, N> x) const {
-            Coordinate *begin = &x[0][0];
-            Coordinate *end = &x[0][0] + N * D;
-
+        FPType operator()(Position<D> const &x) const {
             FPType result =
-                std::transform_reduce(begin, end, FPType{0.f}, std::plus<>(),
-                                      [D_ = D, gamma_ = gamma, &begin](Coordinate &c) {
-                                          // Compute the index of the current element
-                                          auto const index = &c - begin;
-                                          // Check if it is in the last dimension
-                                          bool isLastDimension =
-                                              ((static_cast<UIntType>(index) + 1u) % D_ == 0) && (D_ != 1);
-                                          return c.val * c.val * (isLastDimension ? gamma_ * gamma_ : 1);
-                                      }) *
-                m[0].val * omegaHO * omegaHO / 2;
+                WeightedSquaredNorm<D>(x, LastAxisWeights<D>(gamma * gamma)) * m.val * omegaHO * omegaHO / 2;
             assert(!std::isnan(result));
 
             return result;
         }
     };
+    using PotHO = StructuredPotential<D, N, TrapHO>;
+    // The pair term of the Jastrow factor of hard spheres of diameter a, with its first two derivatives
+    struct JastrowHO {
+        FPType a;
+        PairTerm operator()(FPType r) const {
+            FPType const rTimesRMinusA = r * (r - a);
+            return PairTerm{FastLog(FPType{1} - a / r), a / rTimesRMinusA,
+                            (a * a - 2 * a * r) / (rTimesRMinusA * rTimesRMinusA)};
+        }
+    };
+    using JastrowTableHO = RadialTable<JastrowHO>;
     struct WavefHO {
         FPType beta;
         FPType a;
-        FPType operator()(Positions<D, N> x, VarParams<1> alpha) const {
+        JastrowTableHO const &jastrow;
+        FPType operator()(Positions<D, N> const &x, VarParams<1> alpha) const {
             //   Harmonic oscillator term
-            Coordinate *begin = &x[0][0];
-            Coordinate *end = &x[0][0] + N * D;
-
-            FPType expArg = std::transform_reduce(
-                begin, end, FPType{0}, std::plus<>(), [beta_ = beta, &begin](Coordinate &c) {
-                    auto const index = &c - begin;
-                    bool isLastDimension = ((static_cast<UIntType>(index) + 1u) % D == 0) && (D != 1);
-                    return c.val * c.val * (isLastDimension ? beta_ : 1);
-                });
+            FPType const expArg = WeightedSquaredNorm<D, N>(x, LastAxisWeights<D>(beta));
             // Interaction term
             FPType interactionTerm = FPType{0.f};
 
+            SoAPositions<D, N> const soaX{x};
+            auto const u{[&jastrow = jastrow](FPType r) { return jastrow.Value(r); }};
             for (ParticNum i = 0u; i < N - 1; i++) {
-                for (ParticNum j = i + 1u; j < N; j++) {
-                    FPType r_ij = Distance(x[i], x[j]);
-                    if (r_ij > a) {
-                        interactionTerm += std::log(FPType{1} - a / r_ij);
-                    } else {
-                        return FPType{0};
-                    }
+                PairSum const pairSum = PairSumFrom<D, N>(soaX, i, a, u);
+                if (pairSum.overlap) {
+                    return FPType{0};
                 }
+                interactionTerm += pairSum.u;
             }
             assert(!std::isnan(interactionTerm));
 
-            return std::exp(-alpha[0].val * expArg + interactionTerm);
+            return FastExp(-alpha[0].val * expArg + interactionTerm);
         }
     };
-    struct LaplHO {
+    // Computes the wavefunction, its gradient and its laplacians together, with the vectorized pair kernel
+    struct FusedHO {
         FPType beta;
         FPType a;
-        UIntType particle;
+        JastrowTableHO const &jastrow;
+
+        FusedDerivatives<D, N> operator()(Positions<D, N> const &x, VarParams<1> alpha) const {
+            FusedDerivatives<D, N> result;
+            // Per particle: the gradient of the interaction term, divided by the wavefunction, and the
+            // laplacian of the interaction term
+            std::array<std::array<FPType, D>, N> intVectors;
+            std::array<FPType, N> pureIntTerms;
+            FPType interactionTerm = FPType{0.f};
 
-        LaplHO(FPType beta_, FPType a_, UIntType particle_) : beta{beta_}, a{a_}, particle{particle_} {
-            assert(particle < N);
-        }
-        LaplHO() : beta{}, a{}, particle{} {}
-
-        FPType operator()(Positions<D, N> x, VarParams<1> alpha) const {
-            UIntType uPar = particle;
-            Coordinate *begin = &x[uPar][0];
-            Coordinate *end = &x[uPar][0] + D;
-
-            FPType sumXSqrd = std::transform_reduce(
-                begin, end, FPType{0.f}, std::plus<>(), [D_ = D, beta_ = beta, &begin](Coordinate &c) {
-                    // Compute the index of the current element
-                    auto const index = &c - begin;
-                    // Check if it is in the last dimension
-                    bool isLastDimension = ((static_cast<UIntType>(index) + 1u) % D_ == 0) && (D_ != 1);
-                    return c.val * c.val * (isLastDimension ? beta_ * beta_ : 1);
-                });
-            FPType phiK = std::exp(-alpha[0].val * sumXSqrd);
-
-            FPType nonIntLapl = (std::pow(2 * alpha[0].val, 2) * sumXSqrd -
-                                 2 * alpha[0].val * ((D == 1) ? 1 : (D - 1 + beta))) *
-                                phiK;
-            assert(!std::isnan(nonIntLapl));
-
-            std::vector<FPType> gradHO(D);
-            std::vector<FPType> gradInt(D);
-            FPType innerProd{0};
-
-            std::generate_n(std::back_inserter(gradHO), D, [&, d = Dimension{0u}]() mutable {
-                FPType result =
-                    -2 * alpha[0].val * x[particle][d].val * ((d == (D - 1)) && (D != 1) ? beta : 1) * phiK;
-                d++;
-                return result;
-            });
+            SoAPositions<D, N> const soaX{x};
             for (ParticNum n = 0u; n < N; n++) {
-                if (n == particle) {
-                    continue;
-                }
-                std::generate_n(std::back_inserter(gradInt), D, [&, d = 0u]() mutable {
-                    FPType r_pn = Distance(x[particle], x[n]);
-                    FPType u_pnPrime = a / (r_pn * (r_pn - a));
-                    FPType result = (x[particle][d].val - x[n][d].val) * u_pnPrime / r_pn;
-                    d++;
+                PairSums<D> const pairSums = PairSumsFrom<D, N>(soaX, n, a, jastrow);
+                if (pairSums.overlap) {
+                    // The wavefunction and all of its derivatives vanish inside the hard core
+                    result.psi = 0;
+                    for (std::array<FPType, D> &g : result.gradient) {
+                        g.fill(FPType{0});
+                    }
+                    result.laplacians.fill(FPType{0});
                     return result;
-                });
-                innerProd += std::inner_product(gradHO.begin(), gradHO.end(), gradInt.begin(), FPType{0.f});
+                }
+                // Each pair is visited from both of its particles
+                interactionTerm += pairSums.u / 2;
+                intVectors[n] = pairSums.gradient;
+                pureIntTerms[n] = pairSums.laplacian;
             }
+            assert(!std::isnan(interactionTerm));
 
-            FPType pureIntTerms{0};
-            std::vector<FPType> intVector(D);
+            FPType const expArg = WeightedSquaredNorm<D, N>(x, LastAxisWeights<D>(beta));
+            result.psi = FastExp(-alpha[0].val * expArg + interactionTerm);
 
             for (ParticNum n = 0u; n < N; n++) {
-                if (n == particle) {
-                    continue;
-                }
-                FPType r_pn = Distance(x[particle], x[n]);
-                if (r_pn <= a) {
-                    return FPType{0.f};
-                }
-
-                FPType u_pnPrime = a / (r_pn * (r_pn - a));
-                FPType u_pnPrime2 = (a * a - 2 * a * r_pn) / std::pow(r_pn * (r_pn - a), 2);
-
+                FPType const sumXSqrd = WeightedSquaredNorm<D>(x[n], LastAxisWeights<D>(beta * beta));
+                // The laplacian and the gradient of the oscillator term, divided by the term itself
+                FPType const nonIntLapl = 4 * alpha[0].val * alpha[0].val * sumXSqrd -
+                                          2 * alpha[0].val * ((D == 1) ? 1 : (D - 1 + beta));
+                FPType innerProd = 0;
+                FPType intSqrdNorm = 0;
                 for (Dimension d = 0u; d < D; d++) {
-                    intVector[d] += (x[particle][d].val - x[n][d].val) * u_pnPrime / r_pn;
+                    FPType const gradHO =
+                        -2 * alpha[0].val * x[n][d].val * ((d == (D - 1)) && (D != 1) ? beta : 1);
+                    innerProd += gradHO * intVectors[n][d];
+                    intSqrdNorm += intVectors[n][d] * intVectors[n][d];
+                    result.gradient[n][d] = result.psi * (gradHO + intVectors[n][d]);
                 }
-
-                pureIntTerms += u_pnPrime2 + 2 * u_pnPrime / r_pn;
+                result.laplacians[n] =
+                    result.psi * (nonIntLapl + 2 * innerProd + pureIntTerms[n] + intSqrdNorm);
+                assert(!std::isnan(result.laplacians[n]));
             }
-            pureIntTerms +=
-                std::inner_product(intVector.begin(), intVector.end(), intVector.begin(), FPType{0.f});
-            assert(!std::isnan(pureIntTerms));
-
-            FPType result =
-                WavefHO{beta, a}(x, {alpha}) * ((nonIntLapl + 2 * innerProd) / phiK + pureIntTerms);
-            assert(!std::isnan(result));
 
             return result;
         }
@@ -666,11 +577,12 @@ void HOInt(vmcp::StatFuncType statFunction, std::vector<vmcp::FPType> &energyVal
     Masses<N> mass;
     mass.fill(ParticlesMass);
 
-    PotHO potHO{mass, OmegaHO, Gamma};
-    WavefHO wavefHO{Beta, ADistance};
-    std::array<LaplHO, N> laplHO;
-    std::generate(laplHO.begin(), laplHO.end(),
-                  [counter = ParticNum{0}]() mutable { return LaplHO{Beta, ADistance, counter++}; });
+    PotHO potHO{TrapHO{mass[0], OmegaHO, Gamma}, NoPairPotential{}};
+    // Tabulated once, from twice the hard core to the largest distance inside the integration region
+    FPType const maxDistance = coordBounds[0].Length().val * std::sqrt(static_cast<FPType>(D));
+    JastrowTableHO const jastrowTable{JastrowHO{ADistance}, 2 * ADistance, maxDistance};
+    WavefHO wavefHO{Beta, ADistance, jastrowTable};
+    FusedHO const fusedHO{Beta, ADistance, jastrowTable};
 
     Positions<D, N> startPoss = BuildFCCStartPoint_<D, N>(coordBounds, latticeSpacing);
 
@@ -678,8 +590,8 @@ void HOInt(vmcp::StatFuncType statFunction, std::vector<vmcp::FPType> &energyVal
     ParamBounds<1> const alphaBounds{Bound{VarParam{0.1f}, VarParam{2}}};
 
     VMCResult<1> const vmcrBest =
-        VMCEnergy<D, N, 1>(wavefHO, startPoss, alphaBounds, laplHO, mass, potHO, coordBounds, numEnergies,
-                           statFunction, bootstrapSamples, gen);
+        VMCEnergy<D, N, 1>(wavefHO, startPoss, alphaBounds, fusedHO, false, mass, potHO, coordBounds,
+                           numEnergies, statFunction, bootstrapSamples, gen);
     // Division by N in order to plot Energy / # of particles
     ConfInterval confInt =
         GetConfInt(Energy{vmcrBest.energy.val / N}, Energy{vmcrBest.stdDev.val / N}, confLvl);
@@ -699,6 +611,7 @@ void HOInt(vmcp::StatFuncType statFunction, std::vector<vmcp::FPType> &energyVal
 // Additionaly, commenting single or multiple HOInt function removes only those selected points from
 // the produced graph (obviously the higher the number of particles, the longer the execution time will be)
 int main() {
+    vmcp::PrintCPUFeatures(std::cout);
     vmcp::StatFuncType statFunction = vmcp::StatFuncType::bootstrap;
 
     // Non interacting plots of energy vs (non variational) parameter alpha
@@ -718,4 +631,6 @@ int main() {
     HOInt<3, 7>(statFunction, energyVals, confInts, NVals);
 
     vmcp::DrawGraphInt(energyVals, confInts, NVals);
+
+    vmcp::PrintAllocationCounts(std::cout);
 }
@@ -41,15 +41,30 @@ CoordBounds<D> MakeCoordBounds(Coordinate lower, Coordinate upper) {
     return coordBounds;
 }
 
+//! @brief Generates the weights of an anisotropic harmonic oscillator, which is isotropic apart from the last
+//! dimension
+//! @param lastWeight The weight of the last dimension (ignored if D == 1)
+//! @return An array of D weights, all equal to one apart from the last
+//! @see WeightedSquaredNorm
+template <Dimension D>
+std::array<FPType, D> LastAxisWeights(FPType lastWeight) {
+    std::array<FPType, D> weights;
+    weights.fill(FPType{1});
+    if constexpr (D != 1) {
+        weights[D - 1] = lastWeight;
+    }
+    return weights;
+}
+
 //! @brief Computes Eucledian distance between two particles
 //! @param x The first particle
 //! @param y The second particle
 //! @return The distance
 template <Dimension D>
-FPType Distance(Position<D> x, Position<D> y) {
+FPType Distance(Position<D> const &x, Position<D> const &y) {
     FPType sqrdDist =
         std::inner_product(x.begin(), x.end(), y.begin(), FPType{0}, std::plus<>(),
-                           [](Coordinate &a, Coordinate &b) { return (a.val - b.val) * (a.val - b.val); });
+                           [](Coordinate const &a, Coordinate const &b) { return (a.val - b.val) * (a.val - b.val); });
     return std::sqrt(sqrdDist);
 }
 
@@ -0,0 +1,113 @@
+//!
+//! @file alloctrack.cpp
+//! @brief Definition of the allocation tracking, and replacement of the global allocation functions
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! Must be linked (and 'VMCP_TRACK_ALLOCATIONS' defined) only when the allocations have to be counted.
+//! @see alloctrack.hpp
+//!
+
+#include "alloctrack.hpp"
+
+#ifndef VMCP_TRACK_ALLOCATIONS
+#error "alloctrack.cpp must be compiled with VMCP_TRACK_ALLOCATIONS defined"
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace vmcp {
+
+namespace {
+
+std::array<std::atomic<IntType>, numAllocPhases> allocCounts_{};
+thread_local AllocPhase currentPhase_ = AllocPhase::other;
+#ifdef VMCP_FAIL_ON_SWEEP_ALLOCATION
+std::atomic<bool> failOnSweep_{true};
+#else
+std::atomic<bool> failOnSweep_{false};
+#endif
+
+void CountAllocation_() {
+    allocCounts_[static_cast<UIntType>(currentPhase_)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void *Allocate_(std::size_t size) {
+    CountAllocation_();
+    // malloc(0) may return a null pointer, which 'operator new' must not
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+void *AllocateAligned_(std::size_t size, std::align_val_t alignment) {
+    CountAllocation_();
+    std::size_t const align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment
+    std::size_t const paddedSize = (size + align - 1) / align * align;
+    void *p = std::aligned_alloc(align, paddedSize == 0 ? align : paddedSize);
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+} // namespace
+
+//! @addtogroup alloc-tracking
+//! @{
+
+IntType AllocationCount(AllocPhase phase) {
+    return allocCounts_[static_cast<UIntType>(phase)].load(std::memory_order_relaxed);
+}
+
+void ResetAllocationCounts() {
+    for (std::atomic<IntType> &c : allocCounts_) {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FailOnSweepAllocation(bool fail) { failOnSweep_.store(fail); }
+
+PhaseGuard_::PhaseGuard_(AllocPhase phase)
+    : previous_{currentPhase_}, phase_{phase}, startCount_{AllocationCount(phase)} {
+    currentPhase_ = phase;
+}
+
+PhaseGuard_::~PhaseGuard_() {
+    currentPhase_ = previous_;
+    if (phase_ == AllocPhase::sweep && failOnSweep_.load()) {
+        IntType const allocations = AllocationCount(AllocPhase::sweep) - startCount_;
+        if (allocations != 0) {
+            std::cerr << "The sweep did " << allocations << " heap allocation(s)\n";
+            std::abort();
+        }
+    }
+}
+
+//! @}
+
+} // namespace vmcp
+
+void *operator new(std::size_t size) { return vmcp::Allocate_(size); }
+void *operator new[](std::size_t size) { return vmcp::Allocate_(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return vmcp::AllocateAligned_(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return vmcp::AllocateAligned_(size, alignment);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,115 @@
+//!
+//! @file alloctrack.hpp
+//! @brief Instrumentation that counts the heap allocations done in each phase of a run
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! When the library is compiled with 'VMCP_TRACK_ALLOCATIONS' defined (CMake option of the same name),
+//! alloctrack.cpp replaces the global 'operator new' with one that counts the allocations, attributing each
+//! of them to the phase the calling thread is in.
+//! The phases are marked by the library with 'PhaseGuard_'.
+//! Without 'VMCP_TRACK_ALLOCATIONS' every function in this file is a no-op and the counts are always zero.
+//! @see alloctrack.cpp
+//!
+
+#ifndef VMCPROJECT_ALLOCTRACK_HPP
+#define VMCPROJECT_ALLOCTRACK_HPP
+
+#include "types.hpp"
+
+#include <ostream>
+
+namespace vmcp {
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief Phase of a run, to which the heap allocations are attributed
+enum class AllocPhase {
+    //! Anything outside of the phases below
+    other,
+    //! The moves that forget the initial conditions
+    burnIn,
+    //! The moves between two measurements of the local energy
+    sweep,
+    //! The measurements of the local energy
+    measurement,
+    //! The statistical analysis of the local energies
+    statistics
+};
+//! @brief Number of values of 'AllocPhase'
+constexpr UIntType numAllocPhases = 5;
+
+//! @}
+
+//! @defgroup alloc-tracking Allocation tracking
+//! @brief Count the heap allocations done in each phase
+//! @{
+
+#ifdef VMCP_TRACK_ALLOCATIONS
+
+//! @brief Whether the allocations are being counted
+constexpr bool allocTracking = true;
+
+//! @brief The number of heap allocations done in a phase since the last reset
+IntType AllocationCount(AllocPhase phase);
+//! @brief Sets all the counts to zero
+void ResetAllocationCounts();
+//! @brief Sets whether a sweep which allocates must abort the program
+//!
+//! Defaults to the value of the 'VMCP_FAIL_ON_SWEEP_ALLOCATION' macro (off if undefined).
+void FailOnSweepAllocation(bool fail);
+
+//! @brief Marks the calling thread as being in a phase, until the guard goes out of scope
+//!
+//! Guards can be nested, the previous phase is restored on destruction.
+//! If failing on sweep allocations was requested, the destructor of a sweep guard aborts the program when
+//! the sweep allocated.
+class PhaseGuard_ {
+  public:
+    explicit PhaseGuard_(AllocPhase phase);
+    ~PhaseGuard_();
+    PhaseGuard_(PhaseGuard_ const &) = delete;
+    PhaseGuard_ &operator=(PhaseGuard_ const &) = delete;
+
+  private:
+    AllocPhase previous_;
+    AllocPhase phase_;
+    IntType startCount_;
+};
+
+#else
+
+constexpr bool allocTracking = false;
+
+inline IntType AllocationCount(AllocPhase) { return 0; }
+inline void ResetAllocationCounts() {}
+inline void FailOnSweepAllocation(bool) {}
+
+class PhaseGuard_ {
+  public:
+    explicit PhaseGuard_(AllocPhase) {}
+    PhaseGuard_(PhaseGuard_ const &) = delete;
+    PhaseGuard_ &operator=(PhaseGuard_ const &) = delete;
+};
+
+#endif
+
+//! @brief Prints the number of allocations done in each phase
+//! @param os The stream to print to
+inline void PrintAllocationCounts(std::ostream &os) {
+    if constexpr (!allocTracking) {
+        os << "Allocation tracking disabled (build with VMCP_TRACK_ALLOCATIONS)\n";
+    } else {
+        os << "Heap allocations: burn-in " << AllocationCount(AllocPhase::burnIn) << ", sweep "
+           << AllocationCount(AllocPhase::sweep) << ", measurement "
+           << AllocationCount(AllocPhase::measurement) << ", statistics "
+           << AllocationCount(AllocPhase::statistics) << ", other " << AllocationCount(AllocPhase::other)
+           << "\n";
+    }
+}
+
+//! @}
+
+} // namespace vmcp
+
+#endif
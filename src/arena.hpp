@@ -0,0 +1,101 @@
+//!
+//! @file arena.hpp
+//! @brief Monotonic arena for the temporaries of one iteration
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! The gradient descent and the statistical analysis create many short-lived vectors, whose lifetime ends
+//! with the iteration that created them.
+//! 'IterationArena' hands out their memory from a single buffer and frees it all at once when the iteration
+//! is over, so that after the first few iterations no heap allocation happens at all.
+//!
+
+#ifndef VMCPROJECT_ARENA_HPP
+#define VMCPROJECT_ARENA_HPP
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace vmcp {
+
+//! @addtogroup algs-constants
+//! @{
+
+//! @brief Size (in bytes) of the buffer of a new arena
+constexpr std::size_t initialSize_arena = std::size_t{1} << 16;
+
+//! @}
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief Monotonic arena, meant to be reset at the end of each iteration
+//!
+//! Allocations are served from an owned buffer by bumping a pointer, and deallocations are no-ops.
+//! When the buffer is exhausted the arena falls back to the heap and keeps track of how much it asked for:
+//! at the next 'Reset' the buffer is enlarged by that amount, so that an iteration which allocates as much as
+//! the previous ones is served entirely by the buffer.
+//! Is not thread-safe: each thread (or each independent gradient descent) must own its arena.
+class IterationArena {
+  public:
+    explicit IterationArena(std::size_t initialSize = initialSize_arena)
+        : buffer_{std::make_unique<std::byte[]>(initialSize)}, bufferSize_{initialSize} {
+        assert(initialSize > 0);
+        monotonic_.emplace(buffer_.get(), bufferSize_, &upstream_);
+    }
+    IterationArena(IterationArena const &) = delete;
+    IterationArena &operator=(IterationArena const &) = delete;
+
+    //! @brief The memory resource to be passed to the containers
+    std::pmr::memory_resource *Resource() { return &*monotonic_; }
+
+    //! @brief Frees everything that was allocated since the last reset
+    //!
+    //! Invalidates all the containers that use the arena.
+    //! If the heap was needed since the last reset, the buffer is enlarged to avoid needing it again.
+    void Reset() {
+        monotonic_.reset();
+        if (upstream_.bytes != 0) {
+            bufferSize_ += upstream_.bytes;
+            buffer_ = std::make_unique<std::byte[]>(bufferSize_);
+            upstream_.bytes = 0;
+        }
+        monotonic_.emplace(buffer_.get(), bufferSize_, &upstream_);
+    }
+
+    //! @brief The size of the buffer (in bytes)
+    std::size_t Capacity() const { return bufferSize_; }
+    //! @brief How many bytes were requested to the heap since the last reset
+    std::size_t HeapBytes() const { return upstream_.bytes; }
+
+  private:
+    //! @brief Forwards to the default resource, counting the requested bytes
+    struct CountingResource_ : std::pmr::memory_resource {
+        std::size_t bytes = 0;
+
+        void *do_allocate(std::size_t size, std::size_t alignment) override {
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+        void do_deallocate(void *p, std::size_t size, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+        bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::size_t bufferSize_;
+    CountingResource_ upstream_;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+};
+
+//! @}
+
+} // namespace vmcp
+
+#endif
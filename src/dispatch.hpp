@@ -0,0 +1,101 @@
+//!
+//! @file dispatch.hpp
+//! @brief Runtime selection of the instruction set used by the vectorized kernels
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! Without architecture flags the compiler targets the x86-64 baseline (SSE2), so the vectorized kernels
+//! use 128 bits registers even on machines with AVX2 or AVX-512.
+//! When 'VMCP_DISPATCH' is defined (CMake option of the same name, on by default) the kernels marked with
+//! 'VMCP_MULTIVERSION' are compiled for the baseline, for AVX2 and for AVX-512, and the dynamic loader picks
+//! the best version the CPU supports when the program starts.
+//! A single binary can then run its best path on every machine.
+//!
+
+#ifndef VMCPROJECT_DISPATCH_HPP
+#define VMCPROJECT_DISPATCH_HPP
+
+#include "types.hpp"
+
+#include <ostream>
+
+namespace vmcp {
+
+//! @defgroup dispatch Dispatch
+//! @brief Choose the instruction set of the kernels at runtime
+//! @{
+
+#if defined(VMCP_DISPATCH) && defined(__x86_64__) && defined(__GNUC__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+//! @brief Whether the kernels are compiled for several instruction sets
+#define VMCP_MULTIVERSION_ENABLED 1
+//! @brief Marks a kernel to be compiled for the baseline, for AVX2 (x86-64-v3) and for AVX-512 (x86-64-v4)
+//!
+//! Only worth it on functions that contain whole loops: the versions cannot be inlined in their callers.
+#define VMCP_MULTIVERSION __attribute__((target_clones("default", "arch=x86-64-v3", "arch=x86-64-v4")))
+#endif
+#endif
+#ifndef VMCP_MULTIVERSION_ENABLED
+#define VMCP_MULTIVERSION_ENABLED 0
+#define VMCP_MULTIVERSION
+#endif
+
+//! @brief The instruction set levels for which the kernels are compiled
+enum class ISALevel {
+    //! x86-64 baseline, or a different architecture
+    baseline,
+    //! x86-64-v3: AVX2 and FMA
+    avx2,
+    //! x86-64-v4: AVX-512 (F, BW, CD, DQ, VL)
+    avx512
+};
+
+//! @brief The level whose version of the kernels runs on this machine
+//!
+//! Is always 'ISALevel::baseline' when the kernels are not multiversioned.
+inline ISALevel ActiveISALevel() {
+#if VMCP_MULTIVERSION_ENABLED
+    // Same order of preference as the dispatcher generated for 'target_clones'
+    if (__builtin_cpu_supports("x86-64-v4")) {
+        return ISALevel::avx512;
+    }
+    if (__builtin_cpu_supports("x86-64-v3")) {
+        return ISALevel::avx2;
+    }
+#endif
+    return ISALevel::baseline;
+}
+
+//! @brief The name of an instruction set level
+inline char const *ISALevelName(ISALevel level) {
+    switch (level) {
+    case ISALevel::avx512:
+        return "x86-64-v4 (AVX-512)";
+    case ISALevel::avx2:
+        return "x86-64-v3 (AVX2)";
+    default:
+        return "baseline";
+    }
+}
+
+//! @brief Prints the vector extensions supported by the CPU and the version of the kernels in use
+//! @param os The stream on which the report is printed
+inline void PrintCPUFeatures(std::ostream &os) {
+    os << "CPU features:";
+#if defined(__x86_64__) && defined(__GNUC__)
+    os << " sse4.2=" << (__builtin_cpu_supports("sse4.2") != 0)
+       << " avx=" << (__builtin_cpu_supports("avx") != 0)
+       << " avx2=" << (__builtin_cpu_supports("avx2") != 0)
+       << " fma=" << (__builtin_cpu_supports("fma") != 0)
+       << " avx512f=" << (__builtin_cpu_supports("avx512f") != 0);
+#else
+    os << " unknown architecture";
+#endif
+    os << "\nKernels: " << (VMCP_MULTIVERSION_ENABLED ? "multiversioned" : "single version") << ", running "
+       << ISALevelName(ActiveISALevel()) << '\n';
+}
+
+//! @}
+
+} // namespace vmcp
+
+#endif
@@ -0,0 +1,399 @@
+//!
+//! @file layout.hpp
+//! @brief Structure-of-arrays position container and the kernels that act on the positions
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! 'Positions' stores the particles one after the other (array-of-structs), which is convenient for the
+//! user but forces per-axis work (anisotropic gaussians, pair distances) to stride through memory.
+//! 'SoAPositions' stores instead one contiguous, aligned and padded array per dimension, so that the loops
+//! over the particles can be vectorized by the compiler.
+//! The kernels in this file accept both layouts, except the pair kernels of the Jastrow factors, which are
+//! only written for 'SoAPositions'.
+//!
+
+#ifndef VMCPROJECT_LAYOUT_HPP
+#define VMCPROJECT_LAYOUT_HPP
+
+#include "dispatch.hpp"
+#include "simdpack.hpp"
+#include "types.hpp"
+#include "vecmath.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+
+namespace vmcp {
+
+//! @addtogroup struct-types
+//! @{
+
+//! @brief Rounds the number of particles up to a multiple of 'simdLanes'
+constexpr ParticNum PaddedParticNum(ParticNum n) { return (n + simdLanes - 1) / simdLanes * simdLanes; }
+
+//! @}
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief Positions of N particles in D dimensions, stored as one array per dimension
+//!
+//! Each array is aligned to 'simdAlignment' and padded with zeros up to 'PaddedParticNum(N)' elements, so
+//! that the loops over the particles need neither a remainder loop nor unaligned loads.
+//! The padding is never read by the accessors, but it is read by the kernels: it must therefore always be
+//! zero, which is guaranteed as long as the coordinates are modified only through the accessors.
+template <Dimension D, ParticNum N>
+class SoAPositions {
+  public:
+    //! @brief Length of each per-dimension array, including the padding
+    static constexpr ParticNum paddedN = PaddedParticNum(N);
+
+    SoAPositions() : axes_{} {}
+    explicit SoAPositions(Positions<D, N> const &poss) : axes_{} { Assign(poss); }
+
+    //! @brief Overwrites the coordinates with the ones in the array-of-structs layout
+    void Assign(Positions<D, N> const &poss) {
+        for (ParticNum n = 0u; n != N; ++n) {
+            SetPosition(n, poss[n]);
+        }
+    }
+    //! @brief Converts back to the array-of-structs layout
+    Positions<D, N> ToPositions() const {
+        Positions<D, N> result;
+        for (ParticNum n = 0u; n != N; ++n) {
+            result[n] = GetPosition(n);
+        }
+        return result;
+    }
+
+    Coordinate Get(ParticNum n, Dimension d) const {
+        assert(n < N);
+        assert(d < D);
+        return Coordinate{axes_[d].vals[n]};
+    }
+    void Set(ParticNum n, Dimension d, Coordinate c) {
+        assert(n < N);
+        assert(d < D);
+        axes_[d].vals[n] = c.val;
+    }
+    Position<D> GetPosition(ParticNum n) const {
+        Position<D> result;
+        for (Dimension d = 0u; d != D; ++d) {
+            result[d] = Get(n, d);
+        }
+        return result;
+    }
+    void SetPosition(ParticNum n, Position<D> const &p) {
+        for (Dimension d = 0u; d != D; ++d) {
+            Set(n, d, p[d]);
+        }
+    }
+
+    //! @brief Raw access to the (aligned and padded) coordinates along one dimension
+    //!
+    //! Meant for the kernels only: the padding must be left untouched.
+    FPType const *Axis(Dimension d) const {
+        assert(d < D);
+        return axes_[d].vals.data();
+    }
+    //! @copydoc Axis(Dimension) const
+    FPType *Axis(Dimension d) {
+        assert(d < D);
+        return axes_[d].vals.data();
+    }
+
+  private:
+    struct alignas(simdAlignment) AxisArray_ {
+        std::array<FPType, paddedN> vals;
+    };
+    std::array<AxisArray_, D> axes_;
+};
+
+//! @brief Pair term of a Jastrow factor and its first two derivatives, at one distance
+struct PairTerm {
+    FPType u;
+    FPType uPrime;
+    FPType uPrime2;
+};
+//! @brief Sum of the pair terms between one particle and the others
+struct PairSum {
+    FPType u;
+    //! @brief Whether some pair is inside the hard core, in which case 'u' is meaningless
+    bool overlap;
+};
+//! @brief Sums of the pair terms between one particle and all the others, and of their derivatives with
+//! respect to the coordinates of the particle
+template <Dimension D>
+struct PairSums {
+    FPType u;
+    //! @brief The gradient of the sum of the pair terms
+    std::array<FPType, D> gradient;
+    //! @brief The laplacian of the sum of the pair terms
+    FPType laplacian;
+    //! @brief Whether some pair is inside the hard core, in which case the sums are meaningless
+    bool overlap;
+};
+
+//! @}
+
+//! @defgroup layout-kernels Layout kernels
+//! @brief Per-axis kernels, available for both position layouts
+//!
+//! The array-of-structs overloads loop over the particles and then over the dimensions, so no index
+//! arithmetic is needed to know the dimension of a coordinate.
+//! The structure-of-arrays overloads loop over the dimensions and then over the (padded) particles, using
+//! 'simdLanes' independent accumulators so that the reductions vectorize even without '-ffast-math'.
+//! They load the coordinates of 'simdLanes' particles at a time in 'CoordinatePack's, so that the differences
+//! of the coordinates are still checked by the type system.
+//! The kernels that loop over the particles are multiversioned (see dispatch.hpp), those that act on a single
+//! particle are left to be inlined.
+//! @{
+
+//! @brief Loads the coordinates along one dimension of 'simdLanes' consecutive particles
+//! @param poss The positions of the particles
+//! @param block The index of the first particle, which must be a multiple of 'simdLanes'
+//! @param d The dimension
+//! @return The coordinates, where the lanes past the last particle hold the (zero) padding
+template <Dimension D, ParticNum N>
+CoordinatePack LoadPack(SoAPositions<D, N> const &poss, ParticNum block, Dimension d) {
+    assert(block % simdLanes == 0u);
+    assert((block < SoAPositions<D, N>::paddedN));
+    FPType const *x = poss.Axis(d) + block;
+    CoordinatePack result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.vals[l] = x[l];
+    }
+    return result;
+}
+//! @brief Stores the coordinates along one dimension of 'simdLanes' consecutive particles
+//! @param poss The positions of the particles
+//! @param block The index of the first particle, which must be a multiple of 'simdLanes'
+//! @param d The dimension
+//! @param pack The coordinates, where the lanes past the last particle are ignored
+//!
+//! The padding is written with zeros, so it stays valid for the kernels.
+template <Dimension D, ParticNum N>
+void StorePack(SoAPositions<D, N> &poss, ParticNum block, Dimension d, CoordinatePack const &pack) {
+    assert(block % simdLanes == 0u);
+    assert((block < SoAPositions<D, N>::paddedN));
+    FPType *x = poss.Axis(d) + block;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        x[l] = block + l < N ? pack.vals[l] : FPType{0};
+    }
+}
+
+//! @brief Computes the sum over the dimensions of the squared coordinates, each multiplied by a weight
+//! @param p The position of the particle
+//! @param weights The weight of each dimension
+//! @return The weighted squared norm
+template <Dimension D>
+FPType WeightedSquaredNorm(Position<D> const &p, std::array<FPType, D> const &weights) {
+    FPType result = 0;
+    for (Dimension d = 0u; d != D; ++d) {
+        result += weights[d] * p[d].val * p[d].val;
+    }
+    return result;
+}
+
+//! @brief Computes the sum over the particles and the dimensions of the squared coordinates, each multiplied
+//! by the weight of its dimension
+//! @param poss The positions of the particles
+//! @param weights The weight of each dimension
+//! @return The weighted squared norm
+//!
+//! Is the exponent of an anisotropic gaussian.
+template <Dimension D, ParticNum N>
+VMCP_MULTIVERSION
+FPType WeightedSquaredNorm(Positions<D, N> const &poss, std::array<FPType, D> const &weights) {
+    FPType result = 0;
+    for (Position<D> const &p : poss) {
+        result += WeightedSquaredNorm<D>(p, weights);
+    }
+    return result;
+}
+
+//! @copydoc WeightedSquaredNorm(Positions<D, N> const &, std::array<FPType, D> const &)
+template <Dimension D, ParticNum N>
+VMCP_MULTIVERSION
+FPType WeightedSquaredNorm(SoAPositions<D, N> const &poss, std::array<FPType, D> const &weights) {
+    FPType result = 0;
+    for (Dimension d = 0u; d != D; ++d) {
+        FPType const *x = poss.Axis(d);
+        std::array<FPType, simdLanes> partialSums{};
+        for (ParticNum n = 0u; n != SoAPositions<D, N>::paddedN; n += simdLanes) {
+            for (UIntType l = 0u; l != simdLanes; ++l) {
+                partialSums[l] += x[n + l] * x[n + l];
+            }
+        }
+        FPType axisSum = 0;
+        for (FPType ps : partialSums) {
+            axisSum += ps;
+        }
+        result += weights[d] * axisSum;
+    }
+    return result;
+}
+
+//! @brief Computes the squared distances between one particle and all the particles
+//! @param poss The positions of the particles
+//! @param n The index of the particle from which the distances are computed
+//! @param result Where the squared distances are written, the n-th one being zero
+template <Dimension D, ParticNum N>
+VMCP_MULTIVERSION
+void SquaredDistancesFrom(Positions<D, N> const &poss, ParticNum n, std::array<FPType, N> &result) {
+    assert(n < N);
+    Position<D> const &origin = poss[n];
+    std::transform(poss.begin(), poss.end(), result.begin(), [&origin](Position<D> const &p) {
+        FPType sqrdDist = 0;
+        for (Dimension d = 0u; d != D; ++d) {
+            sqrdDist += (p[d].val - origin[d].val) * (p[d].val - origin[d].val);
+        }
+        return sqrdDist;
+    });
+}
+
+//! @copybrief SquaredDistancesFrom(Positions<D, N> const &, ParticNum, std::array<FPType, N> &)
+//! @param poss The positions of the particles
+//! @param n The index of the particle from which the distances are computed
+//! @param result Where the squared distances are written, the n-th one being zero
+//!
+//! The elements of 'result' past the N-th are meaningless (they are the squared distances from the padding)
+//! and must be ignored.
+template <Dimension D, ParticNum N>
+VMCP_MULTIVERSION
+void SquaredDistancesFrom(SoAPositions<D, N> const &poss, ParticNum n,
+                          std::array<FPType, SoAPositions<D, N>::paddedN> &result) {
+    assert(n < N);
+    result.fill(FPType{0});
+    for (Dimension d = 0u; d != D; ++d) {
+        CoordinatePack const origin = CoordinatePack::Broadcast(poss.Get(n, d));
+        for (ParticNum block = 0u; block != SoAPositions<D, N>::paddedN; block += simdLanes) {
+            CoordinatePack const diff = LoadPack(poss, block, d) - origin;
+            for (UIntType l = 0u; l != simdLanes; ++l) {
+                result[block + l] += diff.vals[l] * diff.vals[l];
+            }
+        }
+    }
+}
+
+//! @brief Sums a pair term over the pairs made by one particle and the ones that follow it
+//! @param poss The positions of the particles
+//! @param n The index of the particle
+//! @param hardCore The distance below which two particles overlap
+//! @param u The pair term, which takes the distance between the particles
+//! @return The sum, and whether a pair overlaps
+//!
+//! Summing over n gives the sum over all the pairs, each counted once.
+//! The loop has no branches: the lanes of the particles that do not follow the n-th, of the padding and of
+//! the overlapping pairs evaluate 'u' at a distance outside of the hard core, and are then masked out.
+template <Dimension D, ParticNum N, class PairFunction>
+VMCP_MULTIVERSION
+PairSum PairSumFrom(SoAPositions<D, N> const &poss, ParticNum n, FPType hardCore, PairFunction const &u) {
+    static_assert(std::is_invocable_r_v<FPType, PairFunction, FPType>);
+    assert(n < N);
+    constexpr ParticNum paddedN = SoAPositions<D, N>::paddedN;
+    FPType const safeDist = 2 * hardCore + 1;
+
+    std::array<FPType, simdLanes> uSums{};
+    std::array<FPType, simdLanes> overlaps{};
+    // Starts from the block that contains the first particle after the n-th
+    for (ParticNum block = (n + 1u) / simdLanes * simdLanes; block != paddedN; block += simdLanes) {
+        // Holds the squared distances until the square roots are taken
+        std::array<FPType, simdLanes> dists{};
+        for (Dimension d = 0u; d != D; ++d) {
+            CoordinatePack const diff = LoadPack(poss, block, d) - CoordinatePack::Broadcast(poss.Get(n, d));
+            for (UIntType l = 0u; l != simdLanes; ++l) {
+                dists[l] += diff.vals[l] * diff.vals[l];
+            }
+        }
+        SqrtInPlace(dists);
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            FPType const r = dists[l];
+            bool const counted = block + l > n && block + l < N;
+            bool const inside = r <= hardCore;
+            FPType const mask = counted && !inside ? FPType{1} : FPType{0};
+            overlaps[l] += counted && inside ? FPType{1} : FPType{0};
+            uSums[l] += mask * u(mask != 0 ? r : safeDist);
+        }
+    }
+
+    PairSum result{0, false};
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.u += uSums[l];
+        result.overlap = result.overlap || overlaps[l] != 0;
+    }
+    return result;
+}
+
+//! @brief Sums a pair term, and its gradient and laplacian with respect to one particle, over the pairs made
+//! by that particle and all the others
+//! @param poss The positions of the particles
+//! @param n The index of the particle
+//! @param hardCore The distance below which two particles overlap
+//! @param pairFunc The pair term, which takes the distance between the particles and returns the term with
+//! its first two derivatives
+//! @return The sums, and whether a pair overlaps
+//!
+//! The gradient of u(r) is u'(r) times the unit vector from the other particle, and its laplacian is
+//! u''(r) + (D - 1) u'(r) / r.
+//! Masks the lanes that do not contribute like 'PairSumFrom'.
+template <Dimension D, ParticNum N, class PairFunction>
+VMCP_MULTIVERSION
+PairSums<D> PairSumsFrom(SoAPositions<D, N> const &poss, ParticNum n, FPType hardCore,
+                         PairFunction const &pairFunc) {
+    static_assert(std::is_invocable_r_v<PairTerm, PairFunction, FPType>);
+    assert(n < N);
+    constexpr ParticNum paddedN = SoAPositions<D, N>::paddedN;
+    FPType const safeDist = 2 * hardCore + 1;
+
+    std::array<FPType, simdLanes> uSums{};
+    std::array<std::array<FPType, simdLanes>, D> gradSums{};
+    std::array<FPType, simdLanes> laplSums{};
+    std::array<FPType, simdLanes> overlaps{};
+    for (ParticNum block = 0u; block != paddedN; block += simdLanes) {
+        std::array<CoordinatePack, D> diffs;
+        // Holds the squared distances until the square roots are taken
+        std::array<FPType, simdLanes> dists{};
+        for (Dimension d = 0u; d != D; ++d) {
+            diffs[d] = CoordinatePack::Broadcast(poss.Get(n, d)) - LoadPack(poss, block, d);
+            for (UIntType l = 0u; l != simdLanes; ++l) {
+                dists[l] += diffs[d].vals[l] * diffs[d].vals[l];
+            }
+        }
+        SqrtInPlace(dists);
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            FPType const r = dists[l];
+            bool const counted = block + l != n && block + l < N;
+            bool const inside = r <= hardCore;
+            FPType const mask = counted && !inside ? FPType{1} : FPType{0};
+            overlaps[l] += counted && inside ? FPType{1} : FPType{0};
+            FPType const safeR = mask != 0 ? r : safeDist;
+            PairTerm const term = pairFunc(safeR);
+            FPType const uPrimeOverR = mask * term.uPrime / safeR;
+            uSums[l] += mask * term.u;
+            laplSums[l] += mask * term.uPrime2 + static_cast<FPType>(D - 1) * uPrimeOverR;
+            for (Dimension d = 0u; d != D; ++d) {
+                gradSums[d][l] += uPrimeOverR * diffs[d].vals[l];
+            }
+        }
+    }
+
+    PairSums<D> result{0, {}, 0, false};
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.u += uSums[l];
+        result.laplacian += laplSums[l];
+        result.overlap = result.overlap || overlaps[l] != 0;
+        for (Dimension d = 0u; d != D; ++d) {
+            result.gradient[d] += gradSums[d][l];
+        }
+    }
+    return result;
+}
+
+//! @}
+
+} // namespace vmcp
+
+#endif
@@ -0,0 +1,149 @@
+//!
+//! @file potential.hpp
+//! @brief Potentials made of a one-body and a pair term, and the incremental tracking of their value
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! A generic potential is a function of the whole configuration, so its value must be recomputed from
+//! scratch after every move.
+//! If instead it is the sum of an external one-body term and of a pair term, moving one particle changes only
+//! the terms that involve that particle: the library can then keep the total up to date in O(N) per move,
+//! instead of O(N^2).
+//!
+
+#ifndef VMCPROJECT_POTENTIAL_HPP
+#define VMCPROJECT_POTENTIAL_HPP
+
+#include "types.hpp"
+#include "vecmath.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+namespace vmcp {
+
+//! @addtogroup algs-constants
+//! @{
+
+//! @brief Number of measurements after which the tracked potential is recomputed from scratch
+//!
+//! Bounds the accumulation of rounding errors in the incremental updates.
+constexpr IntType resyncMeasurements_potTracker = 64;
+
+//! @}
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief Pair term of a potential without interactions
+struct NoPairPotential {
+    FPType operator()(FPType) const { return 0; }
+};
+
+//! @brief Potential which is the sum of a one-body term for each particle and of a pair term for each pair
+//!
+//! 'OneBody' takes the position of a particle, 'Pair' takes the distance between two particles.
+//! Is itself a potential, so it can be passed wherever one is expected.
+template <Dimension D, ParticNum N, class OneBody, class Pair = NoPairPotential>
+struct StructuredPotential {
+    static_assert(std::is_invocable_r_v<FPType, OneBody, Position<D> const &>);
+    static_assert(std::is_invocable_r_v<FPType, Pair, FPType>);
+
+    OneBody oneBody;
+    Pair pair;
+
+    //! @brief The potential of the whole configuration
+    FPType operator()(Positions<D, N> const &poss) const {
+        FPType result = 0;
+        for (ParticNum n = 0u; n != N; ++n) {
+            result += oneBody(poss[n]);
+            if constexpr (!std::is_same_v<Pair, NoPairPotential>) {
+                for (ParticNum m = n + 1u; m != N; ++m) {
+                    result += pair(Distance_(poss[n], poss[m]));
+                }
+            }
+        }
+        return result;
+    }
+
+    //! @brief The terms of the potential that involve a particle, as if it were in a given position
+    //! @param poss The positions of the particles (the one of the n-th is ignored)
+    //! @param n The index of the particle
+    //! @param p The position of the n-th particle
+    //! @return The one-body term of the particle plus its pair terms with all the others
+    FPType ParticleTerms(Positions<D, N> const &poss, ParticNum n, Position<D> const &p) const {
+        assert(n < N);
+        FPType result = oneBody(p);
+        if constexpr (!std::is_same_v<Pair, NoPairPotential>) {
+            for (ParticNum m = 0u; m != N; ++m) {
+                if (m != n) {
+                    result += pair(Distance_(p, poss[m]));
+                }
+            }
+        }
+        return result;
+    }
+
+  private:
+    static FPType Distance_(Position<D> const &p, Position<D> const &q) {
+        FPType sqrdDist = 0;
+        for (Dimension d = 0u; d != D; ++d) {
+            sqrdDist += (p[d].val - q[d].val) * (p[d].val - q[d].val);
+        }
+        return FastSqrt(sqrdDist);
+    }
+};
+
+//! @brief Checks whether a potential is a 'StructuredPotential', whose value can be tracked incrementally
+template <class Potential>
+struct IsStructuredPotential : std::false_type {};
+template <Dimension D, ParticNum N, class OneBody, class Pair>
+struct IsStructuredPotential<StructuredPotential<D, N, OneBody, Pair>> : std::true_type {};
+
+//! @brief Keeps the value of the potential at the positions of a walker
+//!
+//! For a 'StructuredPotential' the value is updated incrementally after each accepted move, otherwise the
+//! potential is evaluated on the whole configuration when the value is asked for.
+template <Dimension D, ParticNum N, class Potential>
+class PotentialTracker_ {
+  public:
+    PotentialTracker_(Potential const &pot, Positions<D, N> const &poss) : pot_{pot}, total_{} {
+        static_assert(IsPotential<D, N, Potential>());
+        Resync(poss);
+    }
+
+    //! @brief Takes into account that a particle was moved
+    //! @param poss The positions, after the move
+    //! @param n The index of the particle that was moved
+    //! @param oldPos The position of the particle before the move
+    void Moved(Positions<D, N> const &poss, ParticNum n, Position<D> const &oldPos) {
+        if constexpr (IsStructuredPotential<Potential>::value) {
+            total_ += pot_.ParticleTerms(poss, n, poss[n]) - pot_.ParticleTerms(poss, n, oldPos);
+        }
+    }
+
+    //! @brief Recomputes the value from scratch
+    void Resync(Positions<D, N> const &poss) {
+        if constexpr (IsStructuredPotential<Potential>::value) {
+            total_ = pot_(poss);
+        }
+    }
+
+    //! @brief The value of the potential at the given positions, which must be the ones of the last move
+    FPType Value(Positions<D, N> const &poss) const {
+        if constexpr (IsStructuredPotential<Potential>::value) {
+            return total_;
+        } else {
+            return pot_(poss);
+        }
+    }
+
+  private:
+    Potential const &pot_;
+    FPType total_;
+};
+
+//! @}
+
+} // namespace vmcp
+
+#endif
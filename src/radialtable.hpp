@@ -0,0 +1,235 @@
+//!
+//! @file radialtable.hpp
+//! @brief Tabulation of the radial functions of the pair terms
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! The pair terms of the Jastrow factors and of the potentials are functions of the distance only, but each
+//! of their evaluations usually needs a logarithm, an exponential or a few divisions, and there are N^2 / 2
+//! of them per configuration.
+//! 'RadialTable' samples such a function once, together with its first two derivatives, and then replaces
+//! each evaluation with a lookup and three short polynomials.
+//!
+
+#ifndef VMCPROJECT_RADIALTABLE_HPP
+#define VMCPROJECT_RADIALTABLE_HPP
+
+#include "layout.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace vmcp {
+
+//! @addtogroup algs-constants
+//! @{
+
+//! @brief Default error allowed on the value and on the derivatives of a tabulated function
+//!
+//! Half of the significant digits of 'FPType'.
+inline FPType const tolerance_radialTable = std::sqrt(std::numeric_limits<FPType>::epsilon());
+//! @brief Number of intervals of the first table that is tried
+constexpr UIntType initialIntervals_radialTable = 64;
+//! @brief Maximum number of intervals of a table
+//!
+//! Keeps the table in the L2 cache: each interval takes six 'FPType's.
+constexpr UIntType maxIntervals_radialTable = 1u << 14;
+//! @brief Number of points inside each interval at which the error of the table is measured
+constexpr UIntType checkPoints_radialTable = 4;
+//! @brief The error measured at the check points must be below the tolerance divided by this
+//!
+//! Accounts for the points between the check points, where the error may be slightly larger.
+constexpr FPType safetyFactor_radialTable = 2;
+
+//! @}
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief A radial function and its first two derivatives, tabulated with piecewise quintic polynomials
+//!
+//! The function must return a 'PairTerm', like the ones taken by 'PairSumsFrom', and the table itself can be
+//! passed wherever such a function is expected.
+//! The table is uniform in the inverse distance x = 1 / r, in which the usual pair terms are smooth: the
+//! inverse powers are polynomials, and the singularity of a hard core of radius a, which sits at x = 1 / a,
+//! is as far from the tabulated range in x as it is (relatively) in r.
+//! The range of x is split in equal intervals, and on each of them the function is replaced by the quintic
+//! polynomial that matches its value and its first two derivatives at both ends (Hermite interpolation), so
+//! the value, the first and the second derivative are continuous across the intervals.
+//! The number of intervals is doubled until the error, relative to the exact result or absolute if that is
+//! smaller than one, is below the tolerance for the value and both derivatives, or until it stops
+//! decreasing.
+//! Outside of [rMin, rMax) the function is evaluated directly, so the range needs to cover only the
+//! distances that are common.
+template <class PairFunction>
+class RadialTable {
+    static_assert(std::is_invocable_r_v<PairTerm, PairFunction, FPType>);
+
+  public:
+    //! @brief Tabulates a function
+    //! @param func The function, which takes the distance and returns the pair term with its derivatives
+    //! @param rMin The start of the tabulated range
+    //! @param rMax The end of the tabulated range
+    //! @param tolerance The error allowed on the value and on the derivatives
+    RadialTable(PairFunction const &func, FPType rMin, FPType rMax, FPType tolerance = tolerance_radialTable)
+        : func_{func}, rMin_{rMin}, rMax_{rMax}, xMin_{1 / rMax} {
+        assert(rMin > 0);
+        assert(rMin < rMax);
+        assert(tolerance > 0);
+        FPType previousError = std::numeric_limits<FPType>::infinity();
+        for (UIntType intervals = initialIntervals_radialTable;; intervals *= 2) {
+            Build_(intervals);
+            errorBound_ = safetyFactor_radialTable * MeasureError_();
+            if (errorBound_ <= tolerance || intervals == maxIntervals_radialTable) {
+                break;
+            }
+            // Once the rounding errors dominate, smaller intervals only make things worse
+            if (errorBound_ >= previousError) {
+                Build_(intervals / 2);
+                errorBound_ = previousError;
+                break;
+            }
+            previousError = errorBound_;
+        }
+        assert(errorBound_ <= tolerance);
+    }
+
+    //! @brief The pair term and its first two derivatives at a distance
+    PairTerm operator()(FPType r) const {
+        if (r < rMin_ || r >= rMax_) {
+            return func_(r);
+        }
+        FPType const x = 1 / r;
+        FPType t;
+        Coefficients_ const &c = Locate_(x, t);
+        FPType const u = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+        // The derivatives with respect to t, then with respect to x, then with respect to r
+        FPType const dt = c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5])));
+        FPType const d2t = 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5]));
+        FPType const dx = dt * invStep_;
+        FPType const d2x = d2t * invStep_ * invStep_;
+        FPType const x2 = x * x;
+        return PairTerm{u, -dx * x2, (d2x * x + 2 * dx) * x2 * x};
+    }
+    //! @brief The pair term alone at a distance
+    //!
+    //! Is the function to pass to 'PairSumFrom' or to a 'StructuredPotential', through a lambda.
+    FPType Value(FPType r) const {
+        if (r < rMin_ || r >= rMax_) {
+            return func_(r).u;
+        }
+        FPType t;
+        Coefficients_ const &c = Locate_(1 / r, t);
+        return c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+    }
+
+    //! @brief The error of the table, which is below the tolerance unless the maximum size was reached
+    FPType ErrorBound() const { return errorBound_; }
+    //! @brief The number of intervals in which the range is split
+    UIntType Intervals() const { return static_cast<UIntType>(coeffs_.size()); }
+
+  private:
+    //! @brief Coefficients of the polynomial of one interval, in the variable t = (x - start) / step
+    using Coefficients_ = std::array<FPType, 6>;
+
+    PairFunction func_;
+    FPType rMin_;
+    FPType rMax_;
+    FPType xMin_;
+    FPType step_;
+    FPType invStep_;
+    std::vector<Coefficients_> coeffs_;
+    FPType errorBound_;
+
+    //! @brief Finds the interval of an inverse distance inside the range, and the position in it (between 0
+    //! and 1)
+    Coefficients_ const &Locate_(FPType x, FPType &t) const {
+        FPType const scaled = (x - xMin_) * invStep_;
+        // The rounding may give the end of the range
+        UIntType const i = std::min(static_cast<UIntType>(scaled), Intervals() - 1u);
+        t = scaled - static_cast<FPType>(i);
+        return coeffs_[i];
+    }
+
+    //! @brief Computes the coefficients of all the intervals
+    //!
+    //! The coefficients of the higher powers are small differences of large terms, so they are computed in
+    //! 'AccumType' even if they are stored in 'FPType'.
+    //! For the same reason the change of the function along an interval is not taken as the difference of
+    //! the values at the ends, whose rounding errors would be amplified in the second derivative, but as the
+    //! integral of the first derivative (with a three points Gauss-Legendre quadrature).
+    void Build_(UIntType intervals) {
+        step_ = (1 / rMin_ - xMin_) / static_cast<FPType>(intervals);
+        invStep_ = 1 / step_;
+        coeffs_.resize(intervals);
+        // The function and its first two derivatives with respect to t, at an end of an interval
+        auto const derivatives{[this](AccumType x) {
+            PairTerm const term = func_(static_cast<FPType>(1 / x));
+            AccumType const du = static_cast<AccumType>(term.uPrime);
+            AccumType const d2u = static_cast<AccumType>(term.uPrime2);
+            AccumType const r = 1 / x;
+            AccumType const h = static_cast<AccumType>(step_);
+            return std::array<AccumType, 3>{static_cast<AccumType>(term.u), -du * r * r * h,
+                                            (d2u * r + 2 * du) * r * r * r * h * h};
+        }};
+        auto const knot{[this](UIntType i) {
+            return static_cast<AccumType>(xMin_) + static_cast<AccumType>(i) * static_cast<AccumType>(step_);
+        }};
+        // Nodes (in t) and weights of the quadrature
+        AccumType const gaussOffset = std::sqrt(0.6) / 2;
+        std::array<AccumType, 3> const gaussNodes{0.5 - gaussOffset, 0.5, 0.5 + gaussOffset};
+        std::array<AccumType, 3> const gaussWeights{5. / 18, 8. / 18, 5. / 18};
+
+        std::array<AccumType, 3> start = derivatives(knot(0u));
+        for (UIntType i = 0u; i != intervals; ++i) {
+            std::array<AccumType, 3> const end = derivatives(knot(i + 1u));
+            auto const [u0, d0, s0] = start;
+            AccumType const d1 = end[1];
+            AccumType const s1 = end[2];
+            AccumType diff = 0;
+            for (UIntType q = 0u; q != gaussNodes.size(); ++q) {
+                AccumType const x = knot(i) + gaussNodes[q] * static_cast<AccumType>(step_);
+                diff += gaussWeights[q] * derivatives(x)[1];
+            }
+            std::array<AccumType, 6> const c{u0,
+                                             d0,
+                                             s0 / 2,
+                                             10 * diff - 6 * d0 - 4 * d1 - 1.5 * s0 + s1 / 2,
+                                             -15 * diff + 8 * d0 + 7 * d1 + 1.5 * s0 - s1,
+                                             6 * diff - 3 * d0 - 3 * d1 - s0 / 2 + s1 / 2};
+            std::transform(c.begin(), c.end(), coeffs_[i].begin(),
+                           [](AccumType coeff) { return static_cast<FPType>(coeff); });
+            start = end;
+        }
+    }
+
+    //! @brief The largest error at the check points of all the intervals
+    FPType MeasureError_() const {
+        auto const error{[](FPType approx, FPType exact) {
+            return std::abs(approx - exact) / (std::abs(exact) + 1);
+        }};
+        FPType result = 0;
+        for (UIntType i = 0u; i != Intervals(); ++i) {
+            for (UIntType k = 1u; k <= checkPoints_radialTable; ++k) {
+                FPType const t = static_cast<FPType>(k) / static_cast<FPType>(checkPoints_radialTable + 1u);
+                FPType const r = 1 / (xMin_ + (static_cast<FPType>(i) + t) * step_);
+                PairTerm const exact = func_(r);
+                PairTerm const approx = (*this)(r);
+                result = std::max({result, error(approx.u, exact.u), error(approx.uPrime, exact.uPrime),
+                                   error(approx.uPrime2, exact.uPrime2)});
+            }
+        }
+        return result;
+    }
+};
+
+//! @}
+
+} // namespace vmcp
+
+#endif
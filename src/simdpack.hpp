@@ -0,0 +1,237 @@
+//!
+//! @file simdpack.hpp
+//! @brief SIMD pack counterparts of the wrapper types
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! The wrapper structs of types.hpp hold one value each, so a kernel that wants to be vectorized has to
+//! unwrap them and work on raw arrays, losing the checks on the physical sense of its operations.
+//! 'Pack' holds instead 'simdLanes' values of the same wrapper type in an aligned array, and applies the
+//! operators lane by lane through the operators of the wrapper itself: an operation is available on packs if
+//! and only if it is available on the wrapper, and gives a pack of the type the wrapper would give.
+//! The loops over the lanes have fixed length and no branches, so the compiler turns them into vector
+//! instructions.
+//!
+
+#ifndef VMCPROJECT_SIMDPACK_HPP
+#define VMCPROJECT_SIMDPACK_HPP
+
+#include "types.hpp"
+
+#include <array>
+#include <cassert>
+#include <type_traits>
+
+namespace vmcp {
+
+//! @addtogroup struct-types
+//! @{
+
+//! @brief Alignment (in bytes) of the arrays that are meant to be vectorized
+//!
+//! Matches the size of a cache line, which is also the width of the largest vector registers available
+//! (AVX-512).
+constexpr UIntType simdAlignment = 64;
+//! @brief Number of floating point numbers that fit in 'simdAlignment' bytes
+constexpr UIntType simdLanes = simdAlignment / sizeof(FPType);
+static_assert(simdAlignment % sizeof(FPType) == 0);
+
+//! @}
+
+//! @addtogroup lexic-types
+//! @{
+
+//! @brief 'simdLanes' values of a wrapper type, one per lane
+//!
+//! The wrapper must be a struct whose only member is a public 'val'.
+//! The values are public, like 'val' in the wrappers, so that a kernel can still reach them when it needs a
+//! quantity without a wrapper type (e.g. the square of a coordinate).
+template <class Scalar>
+struct alignas(simdAlignment) Pack {
+    static_assert(std::is_class_v<Scalar> && sizeof(Scalar) == sizeof(Scalar::val));
+    //! @brief The type of the values held by the wrapper
+    using Value = decltype(Scalar::val);
+
+    std::array<Value, simdLanes> vals;
+
+    //! @brief A pack with the same value in all the lanes
+    static Pack Broadcast(Scalar s) {
+        Pack result;
+        result.vals.fill(s.val);
+        return result;
+    }
+    //! @brief Loads 'simdLanes' consecutive wrappers (e.g. from a 'std::vector<Energy>')
+    static Pack Load(Scalar const *src) {
+        Pack result;
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            result.vals[l] = src[l].val;
+        }
+        return result;
+    }
+    //! @brief Stores the lanes in 'simdLanes' consecutive wrappers
+    void Store(Scalar *dst) const {
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            dst[l].val = vals[l];
+        }
+    }
+    Scalar operator[](UIntType l) const {
+        assert(l < simdLanes);
+        return Scalar{vals[l]};
+    }
+
+    Pack &operator+=(Pack const &other)
+        requires requires(Scalar s) { s += s; }
+    {
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            vals[l] = (Scalar{vals[l]} += Scalar{other.vals[l]}).val;
+        }
+        return *this;
+    }
+    Pack &operator-=(Pack const &other)
+        requires requires(Scalar s) { s -= s; }
+    {
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            vals[l] = (Scalar{vals[l]} -= Scalar{other.vals[l]}).val;
+        }
+        return *this;
+    }
+    Pack &operator*=(Value other)
+        requires requires(Scalar s, Value v) { s *= v; }
+    {
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            vals[l] = (Scalar{vals[l]} *= other).val;
+        }
+        return *this;
+    }
+    Pack &operator/=(Value other)
+        requires requires(Scalar s, Value v) { s /= v; }
+    {
+        for (UIntType l = 0u; l != simdLanes; ++l) {
+            vals[l] = (Scalar{vals[l]} /= other).val;
+        }
+        return *this;
+    }
+};
+//! @brief The result of a comparison of two packs, one boolean per lane
+using PackMask = std::array<bool, simdLanes>;
+
+//! @brief Pack of coordinates, e.g. of the same dimension of 'simdLanes' particles
+using CoordinatePack = Pack<Coordinate>;
+//! @brief Pack of variational parameters
+using VarParamPack = Pack<VarParam>;
+//! @brief Pack of masses
+using MassPack = Pack<Mass>;
+//! @brief Pack of energies, e.g. the local energies of 'simdLanes' configurations
+using EnergyPack = Pack<Energy>;
+//! @brief Pack of squared energies
+using EnSquaredPack = Pack<EnSquared>;
+
+//! @}
+
+//! @defgroup simd-packs SIMD packs
+//! @brief Lane by lane operators of the packs
+//!
+//! Each operator exists only for the packs whose wrapper types have it, for example adding an 'EnergyPack'
+//! to a 'MassPack' does not compile, and multiplying two 'EnergyPack's gives an 'EnSquaredPack'.
+//! The loads and stores of the coordinates from 'SoAPositions' are in layout.hpp.
+//! @{
+
+//! @brief Lane by lane sum
+template <class L, class R>
+    requires requires(L l, R r) { l + r; }
+auto operator+(Pack<L> const &lhs, Pack<R> const &rhs) {
+    Pack<decltype(L{} + R{})> result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.vals[l] = (L{lhs.vals[l]} + R{rhs.vals[l]}).val;
+    }
+    return result;
+}
+//! @brief Lane by lane difference
+template <class L, class R>
+    requires requires(L l, R r) { l - r; }
+auto operator-(Pack<L> const &lhs, Pack<R> const &rhs) {
+    Pack<decltype(L{} - R{})> result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.vals[l] = (L{lhs.vals[l]} - R{rhs.vals[l]}).val;
+    }
+    return result;
+}
+//! @brief Lane by lane product of two packs, e.g. of two 'EnergyPack's
+template <class L, class R>
+    requires requires(L l, R r) { l * r; }
+auto operator*(Pack<L> const &lhs, Pack<R> const &rhs) {
+    Pack<decltype(L{} * R{})> result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.vals[l] = (L{lhs.vals[l]} * R{rhs.vals[l]}).val;
+    }
+    return result;
+}
+//! @brief Product of each lane by a number
+template <class S>
+    requires requires(S s, typename Pack<S>::Value v) { s * v; }
+Pack<S> operator*(Pack<S> lhs, typename Pack<S>::Value rhs) {
+    return lhs *= rhs;
+}
+//! @brief Product of each lane by a number
+template <class S>
+    requires requires(S s, typename Pack<S>::Value v) { v * s; }
+Pack<S> operator*(typename Pack<S>::Value lhs, Pack<S> rhs) {
+    return rhs *= lhs;
+}
+//! @brief Division of each lane by a number
+template <class S>
+    requires requires(S s, typename Pack<S>::Value v) { s / v; }
+Pack<S> operator/(Pack<S> lhs, typename Pack<S>::Value rhs) {
+    return lhs /= rhs;
+}
+//! @brief Lane by lane comparison
+template <class S>
+    requires requires(S s) { s < s; }
+PackMask operator<(Pack<S> const &lhs, Pack<S> const &rhs) {
+    PackMask result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result[l] = S{lhs.vals[l]} < S{rhs.vals[l]};
+    }
+    return result;
+}
+//! @brief Lane by lane comparison
+template <class S>
+    requires requires(S s) { s > s; }
+PackMask operator>(Pack<S> const &lhs, Pack<S> const &rhs) {
+    PackMask result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result[l] = S{lhs.vals[l]} > S{rhs.vals[l]};
+    }
+    return result;
+}
+
+//! @brief Chooses each lane from one of two packs, without branches
+//! @param mask Which pack each lane is taken from
+//! @param ifTrue The pack from which the lanes where 'mask' is true are taken
+//! @param ifFalse The pack from which the other lanes are taken
+//! @return The blended pack
+template <class S>
+Pack<S> Select(PackMask const &mask, Pack<S> const &ifTrue, Pack<S> const &ifFalse) {
+    Pack<S> result;
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result.vals[l] = mask[l] ? ifTrue.vals[l] : ifFalse.vals[l];
+    }
+    return result;
+}
+//! @brief Sums the lanes of a pack
+//!
+//! The lanes are added in a fixed order, so the result does not depend on the instruction set.
+template <class S>
+    requires requires(S s) { s += s; }
+S Sum(Pack<S> const &pack) {
+    S result{0};
+    for (UIntType l = 0u; l != simdLanes; ++l) {
+        result += S{pack.vals[l]};
+    }
+    return result;
+}
+
+//! @}
+
+} // namespace vmcp
+
+#endif
@@ -29,8 +29,8 @@ ConfInterval GetConfInt(Energy mean, Energy stdDev, FPType confLevel) {
     ConfInterval confInterval;
     boost::math::normal dist(mean.val, stdDev.val);
 
-    FPType probability = 1 - (1 - confLevel / 100) / 2;
-    FPType z = boost::math::quantile(dist, probability);
+    AccumType probability = 1 - (1 - static_cast<AccumType>(confLevel) / 100) / 2;
+    AccumType z = boost::math::quantile(dist, probability);
 
     confInterval.min = mean - stdDev * z;
     confInterval.max = mean + stdDev * z;
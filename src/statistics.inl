@@ -12,14 +12,20 @@
 #ifndef VMCPROJECT_STATISTICS_INL
 #define VMCPROJECT_STATISTICS_INL
 
+#include "dispatch.hpp"
+#include "layout.hpp"
 #include "statistics.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <fstream>
 #include <limits>
+#include <memory_resource>
 #include <numeric>
 #include <ranges>
+#include <span>
 #include <vector>
 
 namespace vmcp {
@@ -40,47 +46,86 @@ constexpr Energy threshold_blockingAnalysis{0.05f};
 //! @brief Help the core functions.
 //! @{
 
+//! @brief Sums a quantity over a range of items
+//! @param items The items
+//! @param quantity Gives the quantity to be summed for each item
+//! @return The sum
+//!
+//! Keeps one partial sum per SIMD lane, so that the loop vectorizes even without '-ffast-math', and is
+//! multiversioned (see dispatch.hpp).
+template <class Item, class Quantity>
+VMCP_MULTIVERSION
+AccumType SumOver_(std::span<Item const> items, Quantity const &quantity) {
+    constexpr std::size_t lanes = simdAlignment / sizeof(AccumType);
+    std::size_t const blocked = items.size() / lanes * lanes;
+
+    std::array<AccumType, lanes> partialSums{};
+    for (std::size_t i = 0; i != blocked; i += lanes) {
+        for (std::size_t l = 0; l != lanes; ++l) {
+            partialSums[l] += quantity(items[i + l]);
+        }
+    }
+    AccumType result = 0;
+    for (std::size_t i = blocked; i != items.size(); ++i) {
+        result += quantity(items[i]);
+    }
+    for (AccumType ps : partialSums) {
+        result += ps;
+    }
+    return result;
+}
+
 //! @brief Calculates the mean
 //! @param v The energies and positions, where only the energies will be averaged
 //! @return The mean
 //!
 //! Helper for 'GetStat'
 template <Dimension D, ParticNum N>
-Energy Mean(std::vector<LocEnAndPoss<D, N>> const &v) {
+Energy Mean(std::span<LocEnAndPoss<D, N> const> v) {
     assert(v.size() > 1);
     auto const size = std::ssize(v);
 
-    return std::accumulate(v.begin(), v.end(), Energy{0},
-                             [](Energy e, LocEnAndPoss<D, N> leps) { return e + leps.localEn; }) /
-             static_cast<FPType>(size);
+    return Energy{SumOver_(v, [](LocEnAndPoss<D, N> const &leps) { return leps.localEn.val; })} /
+           static_cast<AccumType>(size);
 };
 
+//! @copydoc Mean(std::span<LocEnAndPoss<D, N> const>)
+template <Dimension D, ParticNum N, class Allocator>
+Energy Mean(std::vector<LocEnAndPoss<D, N>, Allocator> const &v) {
+    return Mean(std::span<LocEnAndPoss<D, N> const>{v});
+}
+
 //! @brief Calculates the error on the mean (by taking just one standard deviation)
 //! @param v The energies and positions, where only the energies will be averaged
 //! @return The standard deviation
 //!
 //! Helper for 'GetStat'
 template <Dimension D, ParticNum N>
-Energy StdDev(std::vector<LocEnAndPoss<D, N>> const &v) {
+Energy StdDev(std::span<LocEnAndPoss<D, N> const> v) {
     assert(v.size() > 1);
     auto const size = std::ssize(v);
 
     Energy const mean = Mean(v);
-    EnSquared const meanVar = std::accumulate(v.begin(), v.end(), EnSquared{0},
-                                              [mean](EnSquared es, LocEnAndPoss<D, N> const &leps) {
-                                                  return es + (leps.localEn - mean) * (leps.localEn - mean);
-                                              }) /
-                              static_cast<FPType>(size * (size - 1));
+    EnSquared const meanVar = EnSquared{SumOver_(v, [mean](LocEnAndPoss<D, N> const &leps) {
+                                  return ((leps.localEn - mean) * (leps.localEn - mean)).val;
+                              })} /
+                              static_cast<AccumType>(size * (size - 1));
     return sqrt(meanVar);
 }
 
+//! @copydoc StdDev(std::span<LocEnAndPoss<D, N> const>)
+template <Dimension D, ParticNum N, class Allocator>
+Energy StdDev(std::vector<LocEnAndPoss<D, N>, Allocator> const &v) {
+    return StdDev(std::span<LocEnAndPoss<D, N> const>{v});
+}
+
 //! @brief Calculates the mean or error on the mean (by taking just one standard deviation)
 //! depending on call
 //! @param v The energies and positions, where only the energies will be averaged
 //! @param stat The desired statistic (mean or standard deviation)
 //! @return The evaluation of the desired statistic
 template <Dimension D, ParticNum N>
-Energy GetStat(std::vector<LocEnAndPoss<D, N>> const &v, Statistic stat) {
+Energy GetStat(std::span<LocEnAndPoss<D, N> const> v, Statistic stat) {
     Energy result;
     switch (stat) {
     case Statistic::mean:
@@ -95,34 +140,43 @@ Energy GetStat(std::vector<LocEnAndPoss<D, N>> const &v, Statistic stat) {
     return result;
 }
 
+//! @copydoc GetStat(std::span<LocEnAndPoss<D, N> const>, Statistic)
+template <Dimension D, ParticNum N, class Allocator>
+Energy GetStat(std::vector<LocEnAndPoss<D, N>, Allocator> const &v, Statistic stat) {
+    return GetStat(std::span<LocEnAndPoss<D, N> const>{v}, stat);
+}
+
 //! @brief Fills blocks-vectors with desired statistic
 //! @param energies The energies and positions, where only the energies will be used
 //! @param blockSize size of the blocks for which the desired statistic is evaluated
 //! @param numBlocks number of blocks with size blockSize
 //! @param stat statistic that will be evaluated for each block
+//! @param resource Where the returned vector is allocated
 //! @see BlockingAnalysis
 //! @return A vector of energies (and positions) contaning the statistic for each block
 //!
 //! Helper for 'BlockingAnalysis'
 template <Dimension D, ParticNum N>
-std::vector<LocEnAndPoss<D, N>> GetStatOfEachBlock(std::vector<LocEnAndPoss<D, N>> const &energies,
-                                                   IntType blockSize, IntType numBlocks, Statistic stat) {
+std::pmr::vector<LocEnAndPoss<D, N>> GetStatOfEachBlock(std::span<LocEnAndPoss<D, N> const> energies,
+                                                        IntType blockSize, IntType numBlocks, Statistic stat,
+                                                        std::pmr::memory_resource *resource) {
     assert(numBlocks > 0);
     IntType const numEnergies = static_cast<IntType>(std::ssize(energies));
     assert(numEnergies > 0);
     assert((numEnergies % blockSize) == 0);
 
     // The vector which will contain the statistic of each block
-    std::vector<LocEnAndPoss<D, N>> blockStats;
+    std::pmr::vector<LocEnAndPoss<D, N>> blockStats{resource};
     blockStats.reserve(static_cast<long unsigned int>(numBlocks));
 
     std::generate_n(std::back_inserter(blockStats), numBlocks,
                     [&energies, &numEnergies, &blockSize, &stat, currentBlock = IntType{0}]() mutable {
-                        auto start = energies.begin() + currentBlock * blockSize;
-                        auto end = start + blockSize;
+                        std::span<LocEnAndPoss<D, N> const> const block =
+                            energies.subspan(static_cast<std::size_t>(currentBlock * blockSize),
+                                             static_cast<std::size_t>(blockSize));
 
                         LocEnAndPoss<D, N> blockLEPs;
-                        blockLEPs.localEn = GetStat(std::vector<LocEnAndPoss<D, N>>(start, end), stat);
+                        blockLEPs.localEn = GetStat(block, stat);
                         Position<D> fakePosition;
                         std::fill(fakePosition.begin(), fakePosition.end(),
                                   Coordinate{std::numeric_limits<FPType>::quiet_NaN()});
@@ -138,26 +192,28 @@ std::vector<LocEnAndPoss<D, N>> GetStatOfEachBlock(std::vector<LocEnAndPoss<D, N
 //! @param energies The energies and positions, where only the energies will be used
 //! @param boostrapSamples The number of samples that will be generated
 //! @param gen The random generator
+//! @param resource Where the returned vectors are allocated
 //! @return A vector of energies (and positions) containing the generated samples
 //! @see BootstrapAnalysis
 //!
 //! Helper function for 'BootstrappingAnalysis'
 template <Dimension D, ParticNum N>
-std::vector<std::vector<LocEnAndPoss<D, N>>> BootstrapSamples(std::vector<LocEnAndPoss<D, N>> const &energies,
-                                                              IntType boostrapSamples, RandomGenerator &gen) {
+std::pmr::vector<std::pmr::vector<LocEnAndPoss<D, N>>>
+BootstrapSamples(std::span<LocEnAndPoss<D, N> const> energies, IntType boostrapSamples, RandomGenerator &gen,
+                 std::pmr::memory_resource *resource) {
     IntType const numEnergies = static_cast<IntType>(std::ssize(energies));
     assert(numEnergies > 0);
     assert(boostrapSamples > 0);
 
     std::uniform_int_distribution<> dist(0, numEnergies - 1);
 
-    std::vector<std::vector<LocEnAndPoss<D, N>>> bootstrapSamples;
+    std::pmr::vector<std::pmr::vector<LocEnAndPoss<D, N>>> bootstrapSamples{resource};
     bootstrapSamples.reserve(static_cast<unsigned long int>(boostrapSamples));
 
     // Resample with replacement
     std::generate_n(std::back_inserter(bootstrapSamples), boostrapSamples,
-                    [&energies, &numEnergies, &dist, &gen]() {
-                        std::vector<LocEnAndPoss<D, N>> sample;
+                    [&energies, &numEnergies, &dist, &gen, resource]() {
+                        std::pmr::vector<LocEnAndPoss<D, N>> sample{resource};
                         sample.reserve(static_cast<unsigned long int>(numEnergies));
 
                         // Fill the current sample with random energies
@@ -179,15 +235,16 @@ std::vector<std::vector<LocEnAndPoss<D, N>>> BootstrapSamples(std::vector<LocEnA
 //! @param bootstrapSamples The energies and positions, where only the energies will be used
 //! @param boostrapSamples The number of samples that will be generated
 //! @param stat statistic that will be evaluated for each block
+//! @param resource Where the returned vector is allocated
 //! @return A vector of energies (and positions) containing the calculated statistic for each sample
 //! @see BootstrapSamples
 //!
 //! Helper function for 'BootstrappingAnalysis'
 template <Dimension D, ParticNum N>
-std::vector<LocEnAndPoss<D, N>>
-BootstrapLEPs(std::vector<std::vector<LocEnAndPoss<D, N>>> const &bootstrapSamples, IntType boostrapSamples,
-              Statistic stat) {
-    std::vector<LocEnAndPoss<D, N>> bootstrapVector;
+std::pmr::vector<LocEnAndPoss<D, N>>
+BootstrapLEPs(std::pmr::vector<std::pmr::vector<LocEnAndPoss<D, N>>> const &bootstrapSamples,
+              IntType boostrapSamples, Statistic stat, std::pmr::memory_resource *resource) {
+    std::pmr::vector<LocEnAndPoss<D, N>> bootstrapVector{resource};
     bootstrapVector.reserve(static_cast<long unsigned int>(boostrapSamples));
 
     std::generate_n(std::back_inserter(bootstrapVector), boostrapSamples,
@@ -218,11 +275,13 @@ BootstrapLEPs(std::vector<std::vector<LocEnAndPoss<D, N>>> const &bootstrapSampl
 //! then evaluates means of each block and takes the mean of means and standard deviation of means (for
 //! each block size)
 //! @param energies The energies and positions, where only the energies will be used
+//! @param resource Where the temporary vectors are allocated
 //! @see BlockingAnalysis
 //!
 //! @return Three vectors containing respectively a list of block sizes, means and standard deviations
 template <Dimension D, ParticNum N>
-BlockingResult EvalBlocking(std::vector<LocEnAndPoss<D, N>> const &energies) {
+BlockingResult EvalBlocking(std::span<LocEnAndPoss<D, N> const> energies,
+                            std::pmr::memory_resource *resource) {
     IntType const numEnergies = static_cast<IntType>(std::ssize(energies));
     assert(numEnergies > 0);
 
@@ -236,10 +295,10 @@ BlockingResult EvalBlocking(std::vector<LocEnAndPoss<D, N>> const &energies) {
     stdDevs.reserve(reservedSize);
 
     for (IntType blockSize = 2; blockSize <= numEnergies / 2; blockSize *= 2) {
-        IntType numBlocks = static_cast<IntType>(static_cast<FPType>(numEnergies) / blockSize);
+        IntType numBlocks = static_cast<IntType>(static_cast<AccumType>(numEnergies) / blockSize);
 
-        std::vector<LocEnAndPoss<D, N>> blockMeans =
-            GetStatOfEachBlock(energies, blockSize, numBlocks, Statistic::mean);
+        std::pmr::vector<LocEnAndPoss<D, N>> const blockMeans =
+            GetStatOfEachBlock(energies, blockSize, numBlocks, Statistic::mean, resource);
         blockSizes.push_back(blockSize);
 
         // Statistics
@@ -253,24 +312,35 @@ BlockingResult EvalBlocking(std::vector<LocEnAndPoss<D, N>> const &energies) {
     return BlockingResult{blockSizes, means, stdDevs};
 }
 
+//! @copybrief EvalBlocking(std::span<LocEnAndPoss<D, N> const>, std::pmr::memory_resource *)
+//! @param energies The energies and positions, where only the energies will be used
+//! @param resource Where the temporary vectors are allocated
+//! @return Three vectors containing respectively a list of block sizes, means and standard deviations
+template <Dimension D, ParticNum N, class Allocator>
+BlockingResult EvalBlocking(std::vector<LocEnAndPoss<D, N>, Allocator> const &energies,
+                            std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return EvalBlocking(std::span<LocEnAndPoss<D, N> const>{energies}, resource);
+}
+
 //! @brief Takes the result of EvalBlocking and then looks for the plateau of standard deviation to get the
 //! best estimate of the error.
 //! @see EvalBlocking
 //!
 //! @param energies The energies and positions, where only the energies will be used
+//! @param resource Where the temporary vectors are allocated
 //! @return The best standard deviation
 //!
 //! EvalBlocking also returns "blockSizes" and "means". They are not used by BlockingAnalysis, they are
 //! used for testing blocking method
 //!
 template <Dimension D, ParticNum N>
-Energy BlockingAnalysis(std::vector<LocEnAndPoss<D, N>> const &energies) {
+Energy BlockingAnalysis(std::span<LocEnAndPoss<D, N> const> energies, std::pmr::memory_resource *resource) {
     IntType const numEnergies = static_cast<IntType>(std::ssize(energies));
     // Check that numEnergies is a power of 2 using bitwise AND between the number n and (n - 1)
     assert((numEnergies & (numEnergies - 1)) == 0);
     assert(numEnergies > 1);
 
-    BlockingResult blockingResult = EvalBlocking(energies);
+    BlockingResult blockingResult = EvalBlocking(energies, resource);
 
     // Find the first pair of elements where the difference is below the threshold
     auto pltIt =
@@ -287,22 +357,32 @@ Energy BlockingAnalysis(std::vector<LocEnAndPoss<D, N>> const &energies) {
 //! @param energies The energies and positions, where only the energies will be used
 //! @param boostrapSamples The number of samples that will be generated
 //! @param gen The random generator
+//! @param resource Where the temporary vectors are allocated
 //! @return The mean and standard deviation of bootstrapped samples
 template <Dimension D, ParticNum N>
-Energy BootstrapAnalysis(std::vector<LocEnAndPoss<D, N>> const &energies, IntType const &boostrapSamples,
-                         RandomGenerator &gen) {
+Energy BootstrapAnalysis(std::span<LocEnAndPoss<D, N> const> energies, IntType const &boostrapSamples,
+                         RandomGenerator &gen, std::pmr::memory_resource *resource) {
     // Generate sample with replacement
-    std::vector<std::vector<LocEnAndPoss<D, N>>> bootstrapSamples =
-        BootstrapSamples(energies, boostrapSamples, gen);
+    std::pmr::vector<std::pmr::vector<LocEnAndPoss<D, N>>> const bootstrapSamples =
+        BootstrapSamples(energies, boostrapSamples, gen, resource);
 
     // Calculate std. dev. of each sample vector and place into bootstrapStdDevs
-    std::vector<LocEnAndPoss<D, N>> bootstrapStdDevs =
-        BootstrapLEPs(bootstrapSamples, boostrapSamples, Statistic::stdDev);
+    std::pmr::vector<LocEnAndPoss<D, N>> const bootstrapStdDevs =
+        BootstrapLEPs(bootstrapSamples, boostrapSamples, Statistic::stdDev, resource);
 
     Energy stdDev = GetStat(bootstrapStdDevs, Statistic::mean);
     return stdDev;
 }
 
+//! @copydoc BootstrapAnalysis(std::span<LocEnAndPoss<D, N> const>, IntType const &, RandomGenerator &,
+//! std::pmr::memory_resource *)
+template <Dimension D, ParticNum N, class Allocator>
+Energy BootstrapAnalysis(std::vector<LocEnAndPoss<D, N>, Allocator> const &energies,
+                         IntType const &boostrapSamples, RandomGenerator &gen,
+                         std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return BootstrapAnalysis(std::span<LocEnAndPoss<D, N> const>{energies}, boostrapSamples, gen, resource);
+}
+
 //! @}
 
 //! @defgroup user-functions User functions
@@ -317,16 +397,19 @@ Energy BootstrapAnalysis(std::vector<LocEnAndPoss<D, N>> const &energies, IntTyp
 //! @param function The desired statistical method the user wants to apply to Monte Carlo data
 //! @param boostrapSamples The number of samples that will be generated
 //! @param gen The random generator
+//! @param resource Where the temporary vectors are allocated, for example an 'IterationArena'
 //! @return The error on the average calculated with the desired statistical method
-template <Dimension D, ParticNum N>
-Energy ErrorOnAvg(std::vector<LocEnAndPoss<D, N>> const &energies, StatFuncType function,
-                  IntType const &boostrapSamples, RandomGenerator &gen) {
+template <Dimension D, ParticNum N, class Allocator>
+Energy ErrorOnAvg(std::vector<LocEnAndPoss<D, N>, Allocator> const &energies, StatFuncType function,
+                  IntType const &boostrapSamples, RandomGenerator &gen,
+                  std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    std::span<LocEnAndPoss<D, N> const> const energiesView{energies};
     switch (function) {
     case StatFuncType::blocking:
-        return BlockingAnalysis(energies);
+        return BlockingAnalysis(energiesView, resource);
         break;
     case StatFuncType::bootstrap:
-        return BootstrapAnalysis(energies, boostrapSamples, gen);
+        return BootstrapAnalysis(energiesView, boostrapSamples, gen, resource);
         break;
     case StatFuncType::regular:
         return StdDev(energies);
@@ -33,8 +33,21 @@ namespace vmcp {
 //! Only C++ floating point types are allowed
 //! 'long double' cannot be used due to a bug in the C++ 'atomic' library.
 //! See https://stackoverflow.com/questions/60559650/why-does-stdatomiclong-double-block-indefinitely-in-c14
+//! Is 'float' when 'VMCP_MIXED_PRECISION' is defined (CMake option of the same name), so that the positions,
+//! the wavefunction and the moves take half the memory and twice the SIMD lanes.
+#ifdef VMCP_MIXED_PRECISION
+using FPType = float;
+#else
 using FPType = double;
+#endif
 static_assert(std::is_floating_point_v<FPType>);
+//! @brief Floating point type of the energies and of the sums over the samples
+//!
+//! Is never narrower than 'FPType': in mixed precision mode the sampling runs in 'float', while the
+//! energies, the reweighting sums and the statistics are still accumulated in 'double'.
+using AccumType = double;
+static_assert(std::is_floating_point_v<AccumType>);
+static_assert(sizeof(AccumType) >= sizeof(FPType));
 //! @brief Signed integer type
 //!
 //! The type to use when an integer is needed, even if that integer is guaranteed to be non-negative.
@@ -157,7 +170,7 @@ template <ParticNum N>
 using Masses = std::array<Mass, N>;
 //! @brief Energy of the system
 struct Energy {
-    FPType val;
+    AccumType val;
     Energy &operator+=(Energy other) {
         val += other.val;
         return *this;
@@ -166,11 +179,11 @@ struct Energy {
         val -= other.val;
         return *this;
     }
-    Energy &operator*=(FPType other) {
+    Energy &operator*=(AccumType other) {
         val *= other;
         return *this;
     }
-    Energy &operator/=(FPType other) {
+    Energy &operator/=(AccumType other) {
         val /= other;
         return *this;
     }
@@ -178,16 +191,16 @@ struct Energy {
 };
 inline Energy operator+(Energy lhs, Energy rhs) { return lhs += rhs; }
 inline Energy operator-(Energy lhs, Energy rhs) { return lhs -= rhs; }
-inline Energy operator*(Energy lhs, FPType rhs) { return lhs *= rhs; }
-inline Energy operator*(FPType lhs, Energy rhs) { return rhs * lhs; }
-inline Energy operator/(Energy lhs, FPType rhs) { return lhs /= rhs; }
+inline Energy operator*(Energy lhs, AccumType rhs) { return lhs *= rhs; }
+inline Energy operator*(AccumType lhs, Energy rhs) { return rhs * lhs; }
+inline Energy operator/(Energy lhs, AccumType rhs) { return lhs /= rhs; }
 inline bool operator<(Energy lhs, Energy rhs) { return lhs.val < rhs.val; }
 inline bool operator>(Energy lhs, Energy rhs) { return lhs.val > rhs.val; }
 inline Energy max(Energy lhs, Energy rhs) { return lhs > rhs ? lhs : rhs; }
 inline Energy abs(Energy e) { return Energy{std::abs(e.val)}; };
 //! @brief Square of the energy of the system
 struct EnSquared {
-    FPType val;
+    AccumType val;
     EnSquared &operator+=(EnSquared other) {
         val += other.val;
         return *this;
@@ -196,20 +209,20 @@ struct EnSquared {
         val -= other.val;
         return *this;
     }
-    EnSquared &operator*=(FPType other) {
+    EnSquared &operator*=(AccumType other) {
         val *= other;
         return *this;
     }
-    EnSquared &operator/=(FPType other) {
+    EnSquared &operator/=(AccumType other) {
         val /= other;
         return *this;
     }
 };
 inline EnSquared operator+(EnSquared lhs, EnSquared rhs) { return lhs += rhs; }
 inline EnSquared operator-(EnSquared lhs, EnSquared rhs) { return lhs -= rhs; }
-inline EnSquared operator*(EnSquared lhs, FPType rhs) { return lhs *= rhs; }
-inline EnSquared operator*(FPType lhs, EnSquared rhs) { return rhs * lhs; }
-inline EnSquared operator/(EnSquared lhs, FPType rhs) { return lhs /= rhs; }
+inline EnSquared operator*(EnSquared lhs, AccumType rhs) { return lhs *= rhs; }
+inline EnSquared operator*(AccumType lhs, EnSquared rhs) { return rhs * lhs; }
+inline EnSquared operator/(EnSquared lhs, AccumType rhs) { return lhs /= rhs; }
 inline EnSquared operator*(Energy lhs, Energy rhs) { return EnSquared{lhs.val * rhs.val}; }
 inline Energy sqrt(EnSquared es) { return Energy{std::sqrt(es.val)}; }
 //! @brief Average of the energy and its error, and the best variational parameters
@@ -225,6 +238,48 @@ struct LocEnAndPoss {
     Energy localEn;
     Positions<D, N> positions;
 };
+//! @brief Drift force acting on N particles in D dimensions
+template <Dimension D, ParticNum N>
+using DriftForce = std::array<std::array<FPType, D>, N>;
+//! @brief The wavefunction and its derivatives at one configuration, computed together
+//! @see IsFusedEvaluator
+template <Dimension D, ParticNum N>
+struct FusedDerivatives {
+    FPType psi;
+    //! @brief The derivative of the wavefunction with respect to each coordinate of each particle
+    std::array<std::array<FPType, D>, N> gradient;
+    //! @brief The laplacian of the wavefunction with respect to the coordinates of each particle
+    std::array<FPType, N> laplacians;
+};
+//! @brief Number of D-dimensional work vectors in 'Scratch'
+constexpr UIntType numVectors_scratch = 4;
+//! @brief Fixed-size work space that the library passes to the derivatives of the wavefunction
+//!
+//! A derivative can take a 'Scratch &' as third argument, and use it for its temporaries instead of
+//! allocating them on each call.
+//! The contents are unspecified on entry, and nothing is preserved between calls.
+template <Dimension D, ParticNum N>
+struct Scratch {
+    //! @brief Vectors with one component per dimension (e.g. the gradient of a particle)
+    std::array<std::array<FPType, D>, numVectors_scratch> vectors;
+    //! @brief One value per particle (e.g. the distances from a particle)
+    std::array<FPType, N> perParticle;
+};
+//! @brief State of a walker, which is kept between two updates
+//!
+//! Caches the quantities that depend only on the current positions, so that they are computed once when a
+//! move is accepted and never recomputed when it is rejected.
+//! The drift force is only needed by importance sampling, so it is computed lazily and 'hasDriftForce'
+//! tells whether it is up to date.
+template <Dimension D, ParticNum N>
+struct WalkerState {
+    Positions<D, N> positions;
+    FPType psi;
+    DriftForce<D, N> driftForce;
+    bool hasDriftForce;
+    //! @brief The work space passed to the derivatives of the wavefunction
+    Scratch<D, N> scratch;
+};
 //! @brief One-dimensional interval
 //!
 //! Requires the templated type to be a class (or struct) with public member 'val'.
@@ -279,10 +334,24 @@ constexpr bool IsWavefunction() {
 //! @return Whether the function has the correct signature
 //!
 //! Checks if Function takes the positions of N particles in D dimension and V variational
-//! parameters, and returns a real number.
+//! parameters, and optionally a 'Scratch', and returns a real number.
 template <Dimension D, ParticNum N, VarParNum V, class Function>
 constexpr bool IsWavefunctionDerivative() {
-    return IsWavefunction<D, N, V, Function>();
+    return IsWavefunction<D, N, V, Function>() ||
+           std::is_invocable_r_v<FPType, Function, Positions<D, N> const &, VarParams<V>, Scratch<D, N> &>;
+}
+//! @brief Checks the signature of the function
+//! @return Whether the function has the correct signature
+//!
+//! Checks if Function takes the positions of N particles in D dimension and V variational parameters, and
+//! optionally a 'Scratch', and returns the wavefunction with its derivatives in a 'FusedDerivatives'.
+//! Such a function can replace the gradients and the laplacians, sharing the intermediate results between
+//! the wavefunction and all of its derivatives.
+template <Dimension D, ParticNum N, VarParNum V, class Function>
+constexpr bool IsFusedEvaluator() {
+    return std::is_invocable_r_v<FusedDerivatives<D, N>, Function, Positions<D, N> const &, VarParams<V>> ||
+           std::is_invocable_r_v<FusedDerivatives<D, N>, Function, Positions<D, N> const &, VarParams<V>,
+                                 Scratch<D, N> &>;
 }
 //! @brief Checks the signature of the function
 //! @return Whether the function has the correct signature
@@ -0,0 +1,238 @@
+//!
+//! @file vecmath.hpp
+//! @brief Vectorizable exponential, logarithm and square root
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! The functions of <cmath> are opaque calls which may set 'errno', so the loops that contain them (the
+//! acceptance of the moves, the gaussian and Jastrow factors, the pair distances) are never vectorized.
+//! The functions in this file use only arithmetic and bit manipulations, without branches, so that they are
+//! inlined and the loops over the particles or over the lanes of a block are vectorized.
+//! Their accuracy is bounded by the 'maxRelError_fast...' constants, which the tests check against <cmath>.
+//! When 'VMCP_LIBM_MATH' is defined (CMake option of the same name) they call <cmath> instead, so that a
+//! result can be validated against the reference implementations.
+//!
+
+#ifndef VMCPROJECT_VECMATH_HPP
+#define VMCPROJECT_VECMATH_HPP
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+
+namespace vmcp {
+
+//! @addtogroup algs-constants
+//! @{
+
+//! @brief Maximum relative error of 'FastExp', for arguments between 'minArg_fastExp' and 'maxArg_fastExp'
+constexpr FPType maxRelError_fastExp = 4 * std::numeric_limits<FPType>::epsilon();
+//! @brief Below this 'FastExp' returns zero
+constexpr FPType minArg_fastExp = std::is_same_v<FPType, float> ? -87 : -708;
+//! @brief Above this 'FastExp' returns infinity
+constexpr FPType maxArg_fastExp = std::is_same_v<FPType, float> ? 88 : 709;
+//! @brief Maximum relative error of 'FastLog', for positive normal arguments
+constexpr FPType maxRelError_fastLog = 4 * std::numeric_limits<FPType>::epsilon();
+//! @brief Maximum relative error of 'FastSqrt', for non-negative normal arguments
+constexpr FPType maxRelError_fastSqrt = 4 * std::numeric_limits<FPType>::epsilon();
+
+//! @}
+
+//! @defgroup vec-math Vector math
+//! @brief Branch-free elementary functions, which the compiler can vectorize
+//! @{
+
+#ifdef VMCP_LIBM_MATH
+//! @brief Whether the functions of this group call <cmath>
+constexpr bool libmMath = true;
+#else
+//! @brief Whether the functions of this group call <cmath>
+constexpr bool libmMath = false;
+#endif
+
+//! @brief Layout of the bits of a floating point type, and the lengths of the approximations for it
+template <class T>
+struct FloatBits_;
+template <>
+struct FloatBits_<float> {
+    using Int = std::int32_t;
+    using UInt = std::uint32_t;
+    static constexpr Int mantissaBits = 23;
+    static constexpr Int exponentBias = 127;
+    static constexpr Int expDegree = 7;
+    static constexpr Int logTerms = 5;
+    static constexpr Int sqrtIterations = 3;
+    static constexpr Int rsqrtMagic = 0x5f3759df;
+    // ln(2) split so that the product of its first part with the exponent is exact
+    static constexpr float ln2Hi = 0.693359375f;
+    static constexpr float ln2Lo = -2.12194440e-4f;
+};
+template <>
+struct FloatBits_<double> {
+    using Int = std::int64_t;
+    using UInt = std::uint64_t;
+    static constexpr Int mantissaBits = 52;
+    static constexpr Int exponentBias = 1023;
+    static constexpr Int expDegree = 12;
+    static constexpr Int logTerms = 10;
+    static constexpr Int sqrtIterations = 4;
+    static constexpr Int rsqrtMagic = 0x5fe6eb50c7b537a9;
+    // ln(2) split so that the product of its first part with the exponent is exact
+    static constexpr double ln2Hi = 6.93145751953125e-1;
+    static constexpr double ln2Lo = 1.42860682030941723212e-6;
+};
+
+//! @brief Computes the exponential
+//! @param x The argument
+//! @return e^x, within 'maxRelError_fastExp'
+//!
+//! Writes x = k ln(2) + r with an integer k and |r| <= ln(2) / 2, then computes e^r with its Taylor
+//! polynomial and 2^k by writing k in the exponent bits.
+//! Arguments below 'minArg_fastExp' give zero instead of a subnormal number.
+inline FPType FastExp(FPType x) {
+    if constexpr (libmMath) {
+        return std::exp(x);
+    } else {
+        using Bits = FloatBits_<FPType>;
+        using Int = Bits::Int;
+        constexpr std::array<FPType, Bits::expDegree + 1> inverses{[] {
+            std::array<FPType, Bits::expDegree + 1> result{};
+            for (Int i = 1; i <= Bits::expDegree; ++i) {
+                result[static_cast<std::size_t>(i)] = FPType{1} / static_cast<FPType>(i);
+            }
+            return result;
+        }()};
+        // Adding it rounds to the nearest integer, which is then found in the lowest bits
+        constexpr FPType roundingMagic = FPType{1.5f} * static_cast<FPType>(Int{1} << Bits::mantissaBits);
+
+        FPType const clamped = std::min(std::max(x, minArg_fastExp), maxArg_fastExp);
+        FPType const shifted = clamped * std::numbers::log2e_v<FPType> + roundingMagic;
+        FPType const k = shifted - roundingMagic;
+        Int const kBits = std::bit_cast<Int>(shifted) - std::bit_cast<Int>(roundingMagic);
+        FPType const r = (clamped - k * Bits::ln2Hi) - k * Bits::ln2Lo;
+
+        // Horner's method on 1 + r (1 + r / 2 (1 + r / 3 (...)))
+        FPType poly = 1;
+        for (Int i = Bits::expDegree; i != 0; --i) {
+            poly = 1 + poly * r * inverses[static_cast<std::size_t>(i)];
+        }
+        FPType const scale = std::bit_cast<FPType>((kBits + Bits::exponentBias) << Bits::mantissaBits);
+        FPType const result = poly * scale;
+        return x > maxArg_fastExp ? std::numeric_limits<FPType>::infinity()
+                                  : (x < minArg_fastExp ? FPType{0} : result);
+    }
+}
+
+//! @brief Computes the natural logarithm
+//! @param x The argument, which must not be negative
+//! @return log(x), within 'maxRelError_fastLog'
+//!
+//! Writes x = m 2^e with sqrt(1/2) <= m < sqrt(2), then computes log(m) = 2 atanh((m - 1) / (m + 1)) with
+//! the series of the inverse hyperbolic tangent.
+//! Zero and subnormal arguments give minus infinity.
+inline FPType FastLog(FPType x) {
+    if constexpr (libmMath) {
+        return std::log(x);
+    } else {
+        using Bits = FloatBits_<FPType>;
+        using Int = Bits::Int;
+        using UInt = Bits::UInt;
+        constexpr std::array<FPType, Bits::logTerms> oddInverses{[] {
+            std::array<FPType, Bits::logTerms> result{};
+            for (Int i = 0; i != Bits::logTerms; ++i) {
+                result[static_cast<std::size_t>(i)] = FPType{1} / static_cast<FPType>(2 * i + 1);
+            }
+            return result;
+        }()};
+        constexpr UInt mantissaMask = (UInt{1} << Bits::mantissaBits) - 1;
+        // Its mantissa bits hold an integer, which is then recovered by subtracting it
+        constexpr FPType integerMagic = static_cast<FPType>(UInt{1} << Bits::mantissaBits);
+
+        UInt const bits = std::bit_cast<UInt>(x);
+        // Between 1 and 2, then halved if above sqrt(2)
+        FPType const fullMantissa = std::bit_cast<FPType>(
+            (bits & mantissaMask) | (static_cast<UInt>(Bits::exponentBias) << Bits::mantissaBits));
+        bool const high = fullMantissa > std::numbers::sqrt2_v<FPType>;
+        FPType const m = high ? fullMantissa * FPType{0.5f} : fullMantissa;
+        // Converted without the integer to floating point instructions, which lack 64 bits before AVX-512
+        FPType const biasedExponent =
+            std::bit_cast<FPType>((bits >> Bits::mantissaBits) | std::bit_cast<UInt>(integerMagic)) -
+            integerMagic;
+        FPType const e =
+            biasedExponent - static_cast<FPType>(Bits::exponentBias) + (high ? FPType{1} : FPType{0});
+
+        FPType const s = (m - 1) / (m + 1);
+        FPType const s2 = s * s;
+        FPType series = oddInverses.back();
+        for (Int i = Bits::logTerms - 1; i != 0; --i) {
+            series = series * s2 + oddInverses[static_cast<std::size_t>(i - 1)];
+        }
+        FPType const result = e * Bits::ln2Hi + (2 * s * series + e * Bits::ln2Lo);
+        return x < std::numeric_limits<FPType>::min() ? -std::numeric_limits<FPType>::infinity() : result;
+    }
+}
+
+//! @brief Computes the square root
+//! @param x The argument, which must not be negative
+//! @return sqrt(x), within 'maxRelError_fastSqrt'
+//!
+//! Refines an estimate of 1 / sqrt(x), taken from the exponent bits, with Newton's method, then multiplies it
+//! by x.
+//! Zero gives zero, subnormal arguments are treated as the smallest normal number.
+inline FPType FastSqrt(FPType x) {
+    if constexpr (libmMath) {
+        return std::sqrt(x);
+    } else {
+        using Bits = FloatBits_<FPType>;
+        using Int = Bits::Int;
+        using UInt = Bits::UInt;
+
+        FPType const safeX = std::max(x, std::numeric_limits<FPType>::min());
+        UInt const estimateBits = static_cast<UInt>(Bits::rsqrtMagic) - (std::bit_cast<UInt>(safeX) >> 1);
+        FPType y = std::bit_cast<FPType>(estimateBits);
+        for (Int i = 0; i != Bits::sqrtIterations; ++i) {
+            y = y * (FPType{1.5f} - FPType{0.5f} * safeX * y * y);
+        }
+        FPType const root = x * y;
+        // A last step on the square root itself removes the rounding error of the product
+        return root + FPType{0.5f} * y * (x - root * root);
+    }
+}
+
+//! @brief Replaces each element of an array with its exponential
+//!
+//! Meant for the blocks of 'simdLanes' elements of the layout kernels, on which the loop is vectorized.
+template <std::size_t L>
+void ExpInPlace(std::array<FPType, L> &xs) {
+    for (FPType &x : xs) {
+        x = FastExp(x);
+    }
+}
+//! @brief Replaces each element of an array with its natural logarithm
+//! @copydetails ExpInPlace
+template <std::size_t L>
+void LogInPlace(std::array<FPType, L> &xs) {
+    for (FPType &x : xs) {
+        x = FastLog(x);
+    }
+}
+//! @brief Replaces each element of an array with its square root
+//! @copydetails ExpInPlace
+template <std::size_t L>
+void SqrtInPlace(std::array<FPType, L> &xs) {
+    for (FPType &x : xs) {
+        x = FastSqrt(x);
+    }
+}
+
+//! @}
+
+} // namespace vmcp
+
+#endif
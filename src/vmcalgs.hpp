@@ -38,6 +38,18 @@ VMCResult<V> VMCEnergy(Wavefunction const &, ParamBounds<V>, Gradients<D, N, Fir
                        Laplacians<N, Laplacian> const &, Masses<N>, Potential const &, CoordBounds<D>,
                        StatFuncType, IntType, RandomGenerator &);
 
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FusedEvaluator, class Potential>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &, Positions<D, N> const &, VarParams<V>,
+                                                FusedEvaluator const &, bool, Masses<N>, Potential const &,
+                                                CoordBounds<D>, IntType, RandomGenerator &);
+
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FusedEvaluator, class Potential>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+VMCResult<V> VMCEnergy(Wavefunction const &, Positions<D, N> const &, ParamBounds<V>, FusedEvaluator const &,
+                       bool, Masses<N>, Potential const &, CoordBounds<D>, IntType, StatFuncType,
+                       IntType const &, RandomGenerator &);
+
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Potential>
 std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &, VarParams<V>, bool, FPType, Masses<N>,
                                                 Potential const &, CoordBounds<D>, IntType,
@@ -12,6 +12,7 @@
 #ifndef VMCPROJECT_VMCALGS_INL
 #define VMCPROJECT_VMCALGS_INL
 
+#include "alloctrack.hpp"
 #include "statistics.hpp"
 #include "vmcalgs.hpp"
 #include "vmchelpers.inl"
@@ -31,8 +32,9 @@ namespace vmcp {
 //! laplacians
 //! @param useImpSamp Whether to use importance sampling as the update algorithm (the alternative is
 //! Metropolis)
-//! @param grads The gradients of the particles (unused if 'useAnalytical == false' or 'useImpSamp == false')
-//! @param lapls The laplacians of the particles (unused if 'useAnalytical == false')
+//! @param grads The gradients of the particles, or a fused evaluator (unused if 'useAnalytical == false' or
+//! 'useImpSamp == false')
+//! @param lapls The laplacians of the particles, or a fused evaluator (unused if 'useAnalytical == false')
 //! @param derivativeStep The step used is the numerical estimation of the derivative (unused if
 //! 'useAnalytical == true')
 //! @param masses The masses of the particles
@@ -50,16 +52,14 @@ namespace vmcp {
 //! Adjusts the step size on the fly to best match the target acceptance rate. Depending on 'useAnalytical'
 //! and 'useImpSamp', some parameters are unused. To avoid having the user supply some parameters he does not
 //! care about, wrappers that only ask for the necessary ones are provided.
-template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FirstDerivative, class Laplacian,
-          class Potential>
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class GradientEvaluator,
+          class LaplacianEvaluator, class Potential>
 std::vector<LocEnAndPoss<D, N>>
-VMCLocEnAndPoss_(Wavefunction const &wavef, Positions<D, N> poss, VarParams<V> params, bool useAnalytical,
-                 bool useImpSamp, Gradients<D, N, FirstDerivative> const &grads,
-                 Laplacians<N, Laplacian> const &lapls, FPType derivativeStep, Masses<N> masses,
+VMCLocEnAndPoss_(Wavefunction const &wavef, Positions<D, N> const &startPoss, VarParams<V> params,
+                 bool useAnalytical, bool useImpSamp, GradientEvaluator const &grads,
+                 LaplacianEvaluator const &lapls, FPType derivativeStep, Masses<N> masses,
                  Potential const &pot, CoordBounds<D> bounds, IntType numEnergies, RandomGenerator &gen) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
-    static_assert(IsWavefunctionDerivative<D, N, V, FirstDerivative>());
-    static_assert(IsWavefunctionDerivative<D, N, V, Laplacian>());
     static_assert(IsPotential<D, N, Potential>());
     assert(numEnergies > 0);
 
@@ -70,43 +70,69 @@ VMCLocEnAndPoss_(Wavefunction const &wavef, Positions<D, N> poss, VarParams<V> p
         }));
     FPType step = smallestBound.Length().val / stepDenom_vmcLEPs;
 
+    // The walker holds the only copy of the configuration, and moves it in place from now on
+    WalkerState<D, N> walker = MakeWalkerState_<D, N, V>(wavef, params, startPoss);
+    // Follows the moves of the walker, so that a structured potential is never evaluated from scratch
+    PotentialTracker_<D, N, Potential> potTracker{pot, walker.positions};
+    auto const onAccept{[&potTracker, &walker](ParticNum n, Position<D> const &oldPos) {
+        potTracker.Moved(walker.positions, n, oldPos);
+    }};
+
     std::function<Energy()> localEnergy;
     if (useAnalytical) {
-        localEnergy = std::function<Energy()>{
-            [&]() { return LocalEnergyAnalytic_<D, N>(wavef, params, lapls, masses, pot, poss); }};
+        localEnergy = std::function<Energy()>{[&]() {
+            return LocalEnergyAnalytic_<D, N, V>(params, lapls, masses, potTracker.Value(walker.positions),
+                                                 walker.positions, walker.psi, walker.scratch);
+        }};
     } else {
-        localEnergy = std::function<Energy()>{
-            [&]() { return LocalEnergyNumeric_<D, N>(wavef, params, derivativeStep, masses, pot, poss); }};
+        localEnergy = std::function<Energy()>{[&]() {
+            return LocalEnergyNumeric_<D, N, V>(wavef, params, derivativeStep, masses,
+                                                potTracker.Value(walker.positions), walker.positions,
+                                                walker.psi);
+        }};
     }
     std::function<IntType()> update;
     if (useImpSamp) {
         update = std::function<IntType()>{[&]() {
-            return ImportanceSamplingUpdate_<D, N>(wavef, params, useAnalytical, derivativeStep, grads,
-                                                   masses, poss, gen);
+            return ImportanceSamplingUpdate_<D, N, V>(wavef, params, useAnalytical, derivativeStep, grads,
+                                                      masses, walker, gen, onAccept);
         }};
     } else {
         update = std::function<IntType()>{
-            [&]() { return MetropolisUpdate_<D, N>(wavef, params, poss, step, gen); }};
+            [&]() { return MetropolisUpdate_<D, N, V>(wavef, params, walker, step, gen, onAccept); }};
     }
 
     std::vector<LocEnAndPoss<D, N>> result;
     result.reserve(static_cast<long unsigned int>(numEnergies));
     // Move away from the starting ponit, in order to forget the dependence on the initial conditions
-    for (IntType i = 0; i != movesForgetICs_vmcLEPs; ++i) {
-        update();
+    {
+        PhaseGuard_ const burnIn{AllocPhase::burnIn};
+        for (IntType i = 0; i != movesForgetICs_vmcLEPs; ++i) {
+            update();
+        }
     }
     for (IntType i = 0; i != numEnergies; ++i) {
         IntType succesfulUpdates = 0;
-        for (IntType j = 0; j != autocorrelationMoves_vmcLEPs; ++j) {
-            succesfulUpdates += update();
+        {
+            PhaseGuard_ const sweep{AllocPhase::sweep};
+            for (IntType j = 0; j != autocorrelationMoves_vmcLEPs; ++j) {
+                succesfulUpdates += update();
+            }
+        }
+        {
+            PhaseGuard_ const measurement{AllocPhase::measurement};
+            result.emplace_back(localEnergy(), walker.positions);
+        }
+        if ((i + 1) % resyncMeasurements_potTracker == 0) {
+            potTracker.Resync(walker.positions);
         }
-        result.emplace_back(localEnergy(), poss);
 
         // Adjust the step size
         // Call car = current acc. rate, tar = target acc. rate
         // Add (car - tar)/tar to step, since it increases step if too many moves were accepted and decreases
         // it if too few were accepted
-        FPType currentAcceptRate = succesfulUpdates * FPType{1} / (autocorrelationMoves_vmcLEPs * N);
+        FPType currentAcceptRate = static_cast<FPType>(succesfulUpdates) /
+                                   static_cast<FPType>(autocorrelationMoves_vmcLEPs * N);
         step *= (currentAcceptRate > targetAcceptRate_vmcLEPs ? FPType{11} / 10 : FPType{9} / 10);
     }
 
@@ -146,8 +172,12 @@ VMCResult<V> VMCRBestParams_(VarParams<V> initialParams, ParamBounds<V> bounds,
     FPType gradStep = initialParamsNorm / stepDenom_gradDesc;
     std::array<FPType, V> oldMomentum;
     std::fill_n(oldMomentum.begin(), V, FPType{0});
+    // Owned by this gradient descent, since the descents run in parallel
+    IterationArena arena;
 
     for (IntType i = 0; i != maxLoops_gradDesc; ++i) {
+        // The temporaries of the previous iteration are not needed anymore
+        arena.Reset();
         // The gradient descent should end in a reasonable time
         assert((i + 1) != maxLoops_gradDesc);
         // Better to be turned off if numWalkers_gradDesc != 1
@@ -155,22 +185,25 @@ VMCResult<V> VMCRBestParams_(VarParams<V> initialParams, ParamBounds<V> bounds,
 
         // Update the energy
         std::vector<LocEnAndPoss<D, N>> const currentLEPs = lepsCalc(currentParams);
-        currentEn = Mean(currentLEPs);
+        {
+            PhaseGuard_ const statistics{AllocPhase::statistics};
+            currentEn = Mean(currentLEPs);
+        }
 
         // Compute the gradient by using reweighting and update the momentum
         std::array<Energy, V> energiesIncreasedParam =
-            ReweightedEnergies_<D, N, V>(wavef, currentParams, currentLEPs, gradStep);
+            ReweightedEnergies_<D, N, V>(wavef, currentParams, currentLEPs, gradStep, arena.Resource());
         std::array<Energy, V> energiesDecreasedParam =
-            ReweightedEnergies_<D, N, V>(wavef, currentParams, currentLEPs, -gradStep);
+            ReweightedEnergies_<D, N, V>(wavef, currentParams, currentLEPs, -gradStep, arena.Resource());
         std::array<FPType, V> currentMomentum;
         std::generate_n(currentMomentum.begin(), V,
                         [v = VarParNum{0}, &energiesIncreasedParam, &energiesDecreasedParam, &oldMomentum,
                          gradStep]() mutable {
-                            FPType const result_ =
-                                -FPType{3} / 4 *
+                            FPType const result_ = static_cast<FPType>(
+                                -AccumType{3} / 4 *
                                     (energiesIncreasedParam[v].val - energiesDecreasedParam[v].val) /
-                                    (2 * gradStep) +
-                                FPType{1} / 4 * oldMomentum[v];
+                                    (2 * static_cast<AccumType>(gradStep)) +
+                                AccumType{1} / 4 * static_cast<AccumType>(oldMomentum[v]));
                             assert(!std::isnan(result_));
                             ++v;
                             return result_;
@@ -187,7 +220,8 @@ VMCResult<V> VMCRBestParams_(VarParams<V> initialParams, ParamBounds<V> bounds,
         // Check the termination condition
         if (gradStep / currentParamsNorm < stoppingThreshold_gradDesc) {
             result.energy = currentEn;
-            result.stdDev = ErrorOnAvg(currentLEPs, function, boostrapSamples, gen);
+            PhaseGuard_ const statistics{AllocPhase::statistics};
+            result.stdDev = ErrorOnAvg(currentLEPs, function, boostrapSamples, gen, arena.Resource());
             result.bestParams = currentParams;
             break;
         } else {
@@ -231,6 +265,7 @@ VMCResult<V> VMCRBestParams_(ParamBounds<V> bounds, Wavefunction const &wavef,
     if constexpr (V == VarParNum{0}) {
         VarParams<0u> const fakeParams{};
         std::vector<LocEnAndPoss<D, N>> const vmcLEPs = lepsCalc(fakeParams);
+        PhaseGuard_ const statistics{AllocPhase::statistics};
         return VMCResult<0>{Mean(vmcLEPs), ErrorOnAvg(vmcLEPs, function, boostrapSamples, gen),
                             VarParams<0>{}};
     } else {
@@ -281,7 +316,7 @@ VMCResult<V> VMCRBestParams_(ParamBounds<V> bounds, Wavefunction const &wavef,
 //!
 //! Wrapper for the true 'VMCLocEnAndPoss'.
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Laplacian, class Potential>
-std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> poss,
+std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> const &poss,
                                                 VarParams<V> params, Laplacians<N, Laplacian> const &lapls,
                                                 Masses<N> masses, Potential const &pot, CoordBounds<D> bounds,
                                                 IntType numEnergies, RandomGenerator &gen) {
@@ -312,7 +347,7 @@ std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Posit
 //!
 //! Wrapper for 'VMCLocEnAndPoss'.
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Laplacian, class Potential>
-VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBounds<V> parBounds,
+VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> const &poss, ParamBounds<V> parBounds,
                        Laplacians<N, Laplacian> const &lapls, Masses<N> masses, Potential const &pot,
                        CoordBounds<D> coorBounds, IntType numEnergies, StatFuncType function,
                        IntType const &boostrapSamples, RandomGenerator &gen) {
@@ -341,7 +376,7 @@ VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBou
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FirstDerivative, class Laplacian,
           class Potential>
 std::vector<LocEnAndPoss<D, N>>
-VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> poss, VarParams<V> params,
+VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> const &poss, VarParams<V> params,
                 Gradients<D, N, FirstDerivative> const &grads, Laplacians<N, Laplacian> const &lapls,
                 Masses<N> masses, Potential const &pot, CoordBounds<D> bounds, IntType numEnergies,
                 RandomGenerator &gen) {
@@ -367,7 +402,7 @@ VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> poss, VarParams<V> pa
 //! Wrapper for 'VMCLocEnAndPoss'.
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FirstDerivative, class Laplacian,
           class Potential>
-VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBounds<V> parBounds,
+VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> const &poss, ParamBounds<V> parBounds,
                        Gradients<D, N, FirstDerivative> const &grads, Laplacians<N, Laplacian> const &lapls,
                        Masses<N> masses, Potential const &pot, CoordBounds<D> coorBounds, IntType numEnergies,
                        StatFuncType function, IntType const &boostrapSamples, RandomGenerator &gen) {
@@ -379,6 +414,66 @@ VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBou
                                     boostrapSamples, gen);
 }
 
+//! @brief Computes the energies that will be averaged by using a fused evaluator of the derivatives and
+//! either the Metropolis or the importance sampling algorithm
+//! @param wavef The wavefunction
+//! @param params The variational parameters
+//! @param fused The wavefunction together with its gradient and laplacians
+//! @param useImpSamp Whether to use importance sampling as the update algorithm (the alternative is
+//! Metropolis)
+//! @param masses The masses of the particles
+//! @param pot The potential
+//! @param bounds The integration region
+//! @param numEnergies The number of energies to compute
+//! @param gen The random generator
+//! @return The computed local energies, and the positions of the particles when each local energy was
+//! computed
+//!
+//! Wrapper for the true 'VMCLocEnAndPoss'.
+//! Each local energy and each drift force costs a single call to the fused evaluator, instead of one call
+//! for each gradient and laplacian.
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FusedEvaluator, class Potential>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> const &poss,
+                                                VarParams<V> params, FusedEvaluator const &fused,
+                                                bool useImpSamp, Masses<N> masses, Potential const &pot,
+                                                CoordBounds<D> bounds, IntType numEnergies,
+                                                RandomGenerator &gen) {
+    FPType const fakeStep = std::numeric_limits<FPType>::quiet_NaN();
+    return VMCLocEnAndPoss_<D, N, V>(wavef, poss, params, true, useImpSamp, fused, fused, fakeStep, masses,
+                                     pot, bounds, numEnergies, gen);
+}
+
+//! @brief Computes the energy with error, by using a fused evaluator of the derivatives and either the
+//! Metropolis or the importance sampling algorithm, after finding the best parameter
+//! @param wavef The wavefunction
+//! @param parBounds The interval in which the best parameters should be found
+//! @param fused The wavefunction together with its gradient and laplacians
+//! @param useImpSamp Whether to use importance sampling as the update algorithm (the alternative is
+//! Metropolis)
+//! @param masses The masses of the particles
+//! @param pot The potential
+//! @param coorBounds The integration region
+//! @param numEnergies The number of energies to compute
+//! @param gen The random generator
+//! @return The computed local energies, and the positions of the particles when each local energy was
+//! computed
+//!
+//! Wrapper for 'VMCLocEnAndPoss'.
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FusedEvaluator, class Potential>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> const &poss, ParamBounds<V> parBounds,
+                       FusedEvaluator const &fused, bool useImpSamp, Masses<N> masses, Potential const &pot,
+                       CoordBounds<D> coorBounds, IntType numEnergies, StatFuncType function,
+                       IntType const &boostrapSamples, RandomGenerator &gen) {
+    auto const enPossCalculator{[&](VarParams<V> vps) {
+        return VMCLocEnAndPoss<D, N, V>(wavef, poss, vps, fused, useImpSamp, masses, pot, coorBounds,
+                                        numEnergies, gen);
+    }};
+    return VMCRBestParams_<D, N, V>(parBounds, wavef, enPossCalculator, numWalkers_gradDesc, function,
+                                    boostrapSamples, gen);
+}
+
 //! @brief Computes the energies that will be averaged by numerically estimating the derivative and using
 //! either the Metropolis or the importance sampling algorithm
 //! @param wavef The wavefunction
@@ -396,7 +491,7 @@ VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBou
 //!
 //! Wrapper for the true 'VMCLocEnAndPoss'.
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Potential>
-std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> poss,
+std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Positions<D, N> const &poss,
                                                 VarParams<V> params, bool useImpSamp, FPType derivativeStep,
                                                 Masses<N> masses, Potential const &pot, CoordBounds<D> bounds,
                                                 IntType numEnergies, RandomGenerator &gen) {
@@ -429,7 +524,7 @@ std::vector<LocEnAndPoss<D, N>> VMCLocEnAndPoss(Wavefunction const &wavef, Posit
 //!
 //! Wrapper for 'VMCLocEnAndPoss'.
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Potential>
-VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> poss, ParamBounds<V> parBounds,
+VMCResult<V> VMCEnergy(Wavefunction const &wavef, Positions<D, N> const &poss, ParamBounds<V> parBounds,
                        bool useImpSamp, FPType derivativeStep, Masses<N> masses, Potential const &pot,
                        CoordBounds<D> coorBounds, IntType numEnergies, StatFuncType function,
                        IntType const &boostrapSamples, RandomGenerator &gen) {
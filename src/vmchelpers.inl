@@ -10,7 +10,10 @@
 #ifndef VMCPROJECT_VMCHELPERS_INL
 #define VMCPROJECT_VMCHELPERS_INL
 
+#include "arena.hpp"
+#include "potential.hpp"
 #include "statistics.hpp"
+#include "vecmath.hpp"
 #include "vmcalgs.hpp"
 
 #include <algorithm>
@@ -18,9 +21,11 @@
 #include <execution>
 #include <functional>
 #include <limits>
+#include <memory_resource>
 #include <mutex>
 #include <numeric>
 #include <ranges>
+#include <utility>
 
 namespace vmcp {
 
@@ -36,98 +41,229 @@ namespace vmcp {
 //! @brief Help the update algorithms
 //! @{
 
+//! @brief Observer of the accepted moves that does nothing, default of the update algorithms
+struct IgnoreMoves_ {
+    template <class Pos>
+    void operator()(ParticNum, Pos const &) const {}
+};
+
+//! @brief Evaluates a function after moving one particle in a cardinal direction, without copying the
+//! positions
+//! @param poss The positions of the particles, restored before returning
+//! @param n The index of the particle that will be moved
+//! @param d The index of the cardinal direction in which the particle will be moved
+//! @param delta How much the particle will be moved
+//! @param func The function to evaluate, which takes the positions
+//! @return The value of the function at the displaced positions
+//!
+//! Displaces the particle, evaluates and restores the original coordinate.
+//! The coordinate is saved and written back rather than moved back by '-delta', so that the positions are
+//! restored exactly.
+//! Helper for 'LocalEnergyNumeric_' and 'DriftForceNumeric_'
+template <Dimension D, ParticNum N, class Function>
+FPType EvalDisplaced_(Positions<D, N> &poss, ParticNum n, Dimension d, Coordinate delta,
+                      Function const &func) {
+    assert(d < D);
+    assert(n < N);
+    Coordinate const original = poss[n][d];
+    poss[n][d] += delta;
+    FPType const result = func(std::as_const(poss));
+    poss[n][d] = original;
+    return result;
+}
+
+//! @brief Evaluates a derivative of the wavefunction, passing it the scratch space if it accepts one
+//! @param derivative The derivative
+//! @param poss The positions of the particles
+//! @param params The variational parameters
+//! @param scratch The work space of the walker
+//! @return The value of the derivative
+//! @see Scratch
+template <Dimension D, ParticNum N, VarParNum V, class Derivative>
+FPType EvalDerivative_(Derivative const &derivative, Positions<D, N> const &poss, VarParams<V> params,
+                       Scratch<D, N> &scratch) {
+    static_assert(IsWavefunctionDerivative<D, N, V, Derivative>());
+    if constexpr (std::is_invocable_r_v<FPType, Derivative, Positions<D, N> const &, VarParams<V>,
+                                        Scratch<D, N> &>) {
+        return derivative(poss, params, scratch);
+    } else {
+        return derivative(poss, params);
+    }
+}
+
+//! @brief Evaluates a fused evaluator, passing it the scratch space if it accepts one
+//! @param fused The fused evaluator
+//! @param poss The positions of the particles
+//! @param params The variational parameters
+//! @param scratch The work space of the walker
+//! @return The wavefunction and its derivatives
+//! @see IsFusedEvaluator
+template <Dimension D, ParticNum N, VarParNum V, class FusedEvaluator>
+FusedDerivatives<D, N> EvalFused_(FusedEvaluator const &fused, Positions<D, N> const &poss,
+                                  VarParams<V> params, Scratch<D, N> &scratch) {
+    static_assert(IsFusedEvaluator<D, N, V, FusedEvaluator>());
+    if constexpr (std::is_invocable_r_v<FusedDerivatives<D, N>, FusedEvaluator, Positions<D, N> const &,
+                                        VarParams<V>, Scratch<D, N> &>) {
+        return fused(poss, params, scratch);
+    } else {
+        return fused(poss, params);
+    }
+}
+
 //! @brief Computes the drift force by using its analytic expression
-//! @param wavef The wavefunction
 //! @param poss The current positions of the particles
+//! @param psi The wavefunction evaluated at the current positions
 //! @param params The variational parameters
 //! @param grads The gradients of the wavefunction (one for each particle)
+//! @param scratch The work space passed to the gradients
 //! @return The drift force evaluated analytically
-template <Dimension D, ParticNum N, VarParNum V, class FirstDerivative, class Wavefunction>
-std::array<std::array<FPType, D>, N> DriftForceAnalytic_(Wavefunction const &wavef, Positions<D, N> poss,
-                                                         VarParams<V> params,
-                                                         Gradients<D, N, FirstDerivative> const &grads) {
-    static_assert(IsWavefunction<D, N, V, Wavefunction>());
+template <Dimension D, ParticNum N, VarParNum V, class FirstDerivative>
+DriftForce<D, N> DriftForceAnalytic_(Positions<D, N> const &poss, FPType psi, VarParams<V> params,
+                                     Gradients<D, N, FirstDerivative> const &grads, Scratch<D, N> &scratch) {
     static_assert(IsWavefunctionDerivative<D, N, V, FirstDerivative>());
 
-    std::array<std::array<FPType, D>, N> result;
+    DriftForce<D, N> result;
+    // Sequential, since the scratch space is shared (and a parallel loop allocates its tasks on the heap)
+    for (ParticNum n = 0u; n != N; ++n) {
+        for (Dimension d = 0u; d != D; ++d) {
+            result[n][d] = 2 * EvalDerivative_<D, N, V>(grads[n][d], poss, params, scratch) / psi;
+        }
+    }
 
-    std::transform(std::execution::par_unseq, grads.begin(), grads.end(), result.begin(),
-                   [&wavef, &poss, params](Gradient<D, FirstDerivative> const &g) {
-                       std::array<FPType, D> result_;
-                       std::transform(g.begin(), g.end(), result_.begin(),
-                                      [&wavef, &poss, params](FirstDerivative const &fd) {
-                                          return 2 * fd(poss, params) / wavef(poss, params);
-                                      });
-                       return result_;
-                   });
+    return result;
+}
 
+//! @brief Computes the drift force from the gradient given by a fused evaluator
+//! @param poss The current positions of the particles
+//! @param psi The wavefunction evaluated at the current positions
+//! @param params The variational parameters
+//! @param fused The fused evaluator
+//! @param scratch The work space passed to the fused evaluator
+//! @return The drift force evaluated analytically
+template <Dimension D, ParticNum N, VarParNum V, class FusedEvaluator>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+DriftForce<D, N> DriftForceAnalytic_(Positions<D, N> const &poss, FPType psi, VarParams<V> params,
+                                     FusedEvaluator const &fused, Scratch<D, N> &scratch) {
+    DriftForce<D, N> result = EvalFused_<D, N, V>(fused, poss, params, scratch).gradient;
+    for (std::array<FPType, D> &particleForce : result) {
+        for (FPType &f : particleForce) {
+            f *= 2 / psi;
+        }
+    }
     return result;
 }
 
 //! @brief Computes the drift force by numerically estimating the derivative of the wavefunction
 //! @param wavef The wavefunction
+//! @param poss The current positions of the particles, displaced in place during the computation and
+//! restored before returning
+//! @param psi The wavefunction evaluated at the current positions
 //! @param params The variational parameters
 //! @param step The step size of the jump in the numeric estimate of the derivative
-//! @param poss The current positions of the particles
 //! @return The drift force evaluated numerically
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction>
-std::array<std::array<FPType, D>, N> DriftForceNumeric_(Wavefunction const &wavef, Positions<D, N> poss,
-                                                        VarParams<V> params, FPType step) {
+DriftForce<D, N> DriftForceNumeric_(Wavefunction const &wavef, Positions<D, N> &poss, FPType psi,
+                                    VarParams<V> params, FPType step) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
 
-    std::array<std::array<FPType, D>, N> result;
-    auto const indices = std::ranges::views::iota(VarParNum{0u}, N);
-    std::for_each(
-        std::execution::par_unseq, indices.begin(), indices.end(),
-        [&wavef, &poss, params, step, &result](ParticNum n) {
-            for (Dimension d = 0u; d != D; ++d) {
-                // Numerical derivative correct up to O(step^9)
-                result[n][d] =
-                    2 *
-                    (FPType{1} / 280 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-4 * step}), params) +
-                     FPType{-4} / 105 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-3 * step}), params) +
-                     FPType{1} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-2 * step}), params) +
-                     FPType{-4} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-step}), params) +
-                     FPType{4} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{step}), params) +
-                     FPType{-1} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{2 * step}), params) +
-                     FPType{4} / 105 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{3 * step}), params) +
-                     FPType{-1} / 280 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{4 * step}), params)) /
-                    (step * wavef(poss, params));
+    // Coefficients of the numerical derivative correct up to O(step^9), the i-th for a shift of (i - 4) steps
+    constexpr std::array<FPType, 9> coeffs{FPType{1} / 280, FPType{-4} / 105, FPType{1} / 5,
+                                           FPType{-4} / 5,  FPType{0},        FPType{4} / 5,
+                                           FPType{-1} / 5,  FPType{4} / 105,  FPType{-1} / 280};
+
+    DriftForce<D, N> result;
+    auto const psiFunc{[&wavef, params](Positions<D, N> const &p) { return wavef(p, params); }};
+    // The positions are modified in place, so the particles must be visited sequentially
+    for (ParticNum n = 0u; n != N; ++n) {
+        for (Dimension d = 0u; d != D; ++d) {
+            FPType derivative = 0;
+            for (IntType k = -4; k != 5; ++k) {
+                if (k != 0) {
+                    Coordinate const delta{static_cast<FPType>(k) * step};
+                    derivative += coeffs[static_cast<UIntType>(k + 4)] *
+                                  EvalDisplaced_<D, N>(poss, n, d, delta, psiFunc);
+                }
             }
-        });
+            result[n][d] = 2 * derivative / (step * psi);
+        }
+    }
 
     return result;
 }
 
+//! @brief Computes the drift force, either analytically or numerically
+//! @param wavef The wavefunction
+//! @param poss The current positions of the particles, displaced in place during the computation (if
+//! 'useAnalytical == false') and restored before returning
+//! @param psi The wavefunction evaluated at the current positions
+//! @param params The variational parameters
+//! @param useAnalytical Whether the drift force must be computed by using the analytical expression of the
+//! gardients
+//! @param derivativeStep The step used is the numerical estimation of the drift force derivatives (unused if
+//! 'useAnalytical == true')
+//! @param grads The gradients of the wavefunction, or a fused evaluator (unused if 'useAnalytical == false')
+//! @param scratch The work space passed to the gradients
+//! @return The drift force
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class GradientEvaluator>
+DriftForce<D, N> DriftForce_(Wavefunction const &wavef, Positions<D, N> &poss, FPType psi,
+                             VarParams<V> params, bool useAnalytical, FPType derivativeStep,
+                             GradientEvaluator const &grads, Scratch<D, N> &scratch) {
+    if (useAnalytical) {
+        return DriftForceAnalytic_<D, N, V>(std::as_const(poss), psi, params, grads, scratch);
+    } else {
+        return DriftForceNumeric_<D, N, V>(wavef, poss, psi, params, derivativeStep);
+    }
+}
+
+//! @brief Creates the state of a walker placed at the given positions
+//! @param wavef The wavefunction
+//! @param params The variational parameters
+//! @param poss The positions of the particles
+//! @return The state of the walker, with the drift force not computed yet
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction>
+WalkerState<D, N> MakeWalkerState_(Wavefunction const &wavef, VarParams<V> params,
+                                   Positions<D, N> const &poss) {
+    static_assert(IsWavefunction<D, N, V, Wavefunction>());
+    return WalkerState<D, N>{poss, wavef(poss, params), DriftForce<D, N>{}, false, Scratch<D, N>{}};
+}
+
 //! @}
 
 //! @brief Attempts to update each position once by using the Metropolis algorithm
 //! @param wavef The wavefunction
 //! @param params The variational parameters
-//! @param poss The current positions of the particles, will be modified if some updates succeed
+//! @param walker The current state of the walker, will be modified if some updates succeed
 //! @param step The step size of the jump
 //! @param gen The random generator
+//! @param onAccept Called with the index of the particle and its old position after each accepted move
 //! @return The number of successful updates
 //!
 //! Attempts to update the position of each particle once, sequentially.
 //! An update consists in a random jump in each cardinal direction, after which the Metropolis question is
 //! asked.
-template <Dimension D, ParticNum N, VarParNum V, class Wavefunction>
-IntType MetropolisUpdate_(Wavefunction const &wavef, VarParams<V> params, Positions<D, N> &poss, FPType step,
-                          RandomGenerator &gen) {
+//! The wavefunction at the current positions is taken from the walker, so each attempt costs a single
+//! evaluation of the wavefunction.
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class AcceptObserver = IgnoreMoves_>
+IntType MetropolisUpdate_(Wavefunction const &wavef, VarParams<V> params, WalkerState<D, N> &walker,
+                          FPType step, RandomGenerator &gen, AcceptObserver const &onAccept = {}) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
-    assert(wavef(poss, params) > 1e-12);
+    assert(walker.psi > FPType{1e-12f});
 
     IntType succesfulUpdates = 0;
-    for (Position<D> &p : poss) {
+    for (ParticNum n = 0u; n != N; ++n) {
+        Position<D> &p = walker.positions[n];
         Position const oldPos = p;
-        FPType const oldPsi = wavef(poss, params);
         std::uniform_real_distribution<FPType> unif(0, 1);
         std::transform(p.begin(), p.end(), p.begin(), [&gen, &unif, step](Coordinate c) {
             return c + Coordinate{(unif(gen) - FPType{0.5f}) * step};
         });
-        if (unif(gen) < std::pow(wavef(poss, params) / oldPsi, 2)) {
+        FPType const newPsi = wavef(walker.positions, params);
+        FPType const psiRatio = newPsi / walker.psi;
+        if (unif(gen) < psiRatio * psiRatio) {
             ++succesfulUpdates;
+            walker.psi = newPsi;
+            walker.hasDriftForce = false;
+            onAccept(n, oldPos);
         } else {
             p = oldPos;
         }
@@ -142,42 +278,44 @@ IntType MetropolisUpdate_(Wavefunction const &wavef, VarParams<V> params, Positi
 //! gardients
 //! @param derivativeStep The step used is the numerical estimation of the drift force derivatives (unused if
 //! 'useAnalytical == true')
-//! @param grads The gradients of the wavefunction (one for each particle)
+//! @param grads The gradients of the wavefunction (one for each particle), or a fused evaluator
 //! @param masses The masses of the particles
-//! @param poss The current positions of the particles, will be modified if some updates succeed
-//! @param step The average length of the random part of the jump in changing positions
+//! @param walker The current state of the walker, will be modified if some updates succeed
 //! @param gen The random generator
+//! @param onAccept Called with the index of the particle and its old position after each accepted move
 //! @return The number of successful updates
 //!
 //! This function applies formulas in the end of section 1.4.3 of Nuclear Many-body Physics -
 //! a Computational Approach - Monte Carlo methods, Morten Hjorth-Jensen.
 //! It attempts to update the position of each particle once, sequentially.
-template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class FirstDerivative>
+//! The wavefunction and the drift force at the current positions are taken from the walker, so each attempt
+//! costs one evaluation of the wavefunction and one of the drift force.
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class GradientEvaluator,
+          class AcceptObserver = IgnoreMoves_>
 IntType ImportanceSamplingUpdate_(Wavefunction const &wavef, VarParams<V> params, bool useAnalytical,
-                                  FPType derivativeStep, Gradients<D, N, FirstDerivative> const &grads,
-                                  Masses<N> masses, Positions<D, N> &poss, RandomGenerator &gen) {
+                                  FPType derivativeStep, GradientEvaluator const &grads, Masses<N> masses,
+                                  WalkerState<D, N> &walker, RandomGenerator &gen,
+                                  AcceptObserver const &onAccept = {}) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
-    static_assert(IsWavefunctionDerivative<D, N, V, FirstDerivative>());
 
     std::array<FPType, N> diffConsts;
     std::transform(masses.begin(), masses.end(), diffConsts.begin(),
                    [](Mass m) { return hbar * hbar / (2 * m.val); });
 
+    if (!walker.hasDriftForce) {
+        walker.driftForce = DriftForce_<D, N, V>(wavef, walker.positions, walker.psi, params, useAnalytical,
+                                                 derivativeStep, grads, walker.scratch);
+        walker.hasDriftForce = true;
+    }
+
     IntType successfulUpdates = 0;
     for (ParticNum n = 0u; n != N; ++n) {
-        Position<D> &p = poss[n];
+        Position<D> &p = walker.positions[n];
         Position const oldPos = p;
-        FPType const oldPsi = wavef(poss, params);
-
-        std::array<std::array<FPType, D>, N> oldDriftForce;
-        if (useAnalytical) {
-            oldDriftForce = DriftForceAnalytic_<D, N, V>(wavef, poss, params, grads);
-        } else {
-            oldDriftForce = DriftForceNumeric_<D, N, V>(wavef, poss, params, derivativeStep);
-        }
+        DriftForce<D, N> const &oldDriftForce = walker.driftForce;
 
         // Jensen in his notes, section 1.4.3, suggests a value between 0.001 and 0.01
-        FPType const timeStep = 0.005;
+        FPType const timeStep = FPType{5} / 1000;
 
         std::normal_distribution<FPType> normal(0, 1);
 
@@ -186,34 +324,32 @@ IntType ImportanceSamplingUpdate_(Wavefunction const &wavef, VarParams<V> params
                        normal(gen) * std::sqrt(timeStep);
         }
 
-        FPType const newPsi = wavef(poss, params);
+        FPType const newPsi = wavef(walker.positions, params);
 
         FPType forwardExponent = 0;
         for (Dimension d = 0u; d != D; ++d) {
-            forwardExponent -=
-                std::pow(p[d].val - oldPos[d].val - diffConsts[n] * timeStep * oldDriftForce[n][d], 2) /
-                (4 * diffConsts[n] * timeStep);
+            FPType const shift = p[d].val - oldPos[d].val - diffConsts[n] * timeStep * oldDriftForce[n][d];
+            forwardExponent -= shift * shift / (4 * diffConsts[n] * timeStep);
         }
-        FPType const forwardProb = std::exp(forwardExponent);
 
-        std::array<std::array<FPType, D>, N> newDriftForce;
-        if (useAnalytical) {
-            newDriftForce = DriftForceAnalytic_<D, N, V>(wavef, poss, params, grads);
-        } else {
-            newDriftForce = DriftForceNumeric_<D, N, V>(wavef, poss, params, derivativeStep);
-        }
+        DriftForce<D, N> const newDriftForce = DriftForce_<D, N, V>(
+            wavef, walker.positions, newPsi, params, useAnalytical, derivativeStep, grads, walker.scratch);
         FPType backwardExponent = 0;
         for (Dimension d = 0u; d != D; ++d) {
-            backwardExponent -=
-                std::pow(oldPos[d].val - p[d].val - diffConsts[n] * timeStep * newDriftForce[n][d], 2) /
-                (4 * diffConsts[n] * timeStep);
+            FPType const shift = oldPos[d].val - p[d].val - diffConsts[n] * timeStep * newDriftForce[n][d];
+            backwardExponent -= shift * shift / (4 * diffConsts[n] * timeStep);
         }
-        FPType const backwardProb = std::exp(backwardExponent);
 
-        FPType const acceptanceRatio = (newPsi * newPsi * backwardProb) / (oldPsi * oldPsi * forwardProb);
+        // The acceptance ratio is compared in the log domain, where neither of the transition probabilities
+        // needs an exponential and a small wavefunction cannot underflow when squared
+        FPType const logAcceptanceRatio =
+            2 * FastLog(std::abs(newPsi / walker.psi)) + backwardExponent - forwardExponent;
         std::uniform_real_distribution<FPType> unif(0, 1);
-        if (unif(gen) < acceptanceRatio) {
+        if (FastLog(unif(gen)) < logAcceptanceRatio) {
             ++successfulUpdates;
+            walker.psi = newPsi;
+            walker.driftForce = newDriftForce;
+            onAccept(n, oldPos);
         } else {
             p = oldPos;
         }
@@ -230,49 +366,48 @@ IntType ImportanceSamplingUpdate_(Wavefunction const &wavef, VarParams<V> params
 //! @brief The algorithms that calculate the local energy
 //! @{
 
-//! @defgroup energy-calc-helpers Local energy helpers
-//! @brief The algorithms that calculate the local energy
-//! @{
-
-//! @brief Moves one particle in a cardinal direction
-//! @param poss The positions of the particles
-//! @param d The index of the cardinal direction in which the particle will be moved
-//! @param n The index of the particle that will be moved
-//! @param delta How much the particle will be moved
-//! @return The updated positions
-//!
-//! Helper for 'LocalEnergyNumeric' and 'DriftForceNumeric'
-template <Dimension D, ParticNum N>
-Positions<D, N> MoveBy_(Positions<D, N> const &poss, Dimension d, ParticNum n, Coordinate delta) {
-    assert(d < D);
-    assert(n < N);
-    Positions<D, N> result = poss;
-    result[n][d] += delta;
-    return result;
-}
-
-//! @}
-
 //! @brief Computes the local energy by using the analytic formula for the derivative of the wavefunction
-//! @param wavef The wavefunction
 //! @param params The variational parameters
 //! @param lapls The laplacians, one for each particle
 //! @param masses The masses of the particles
-//! @param pot The potential
+//! @param potEnergy The potential evaluated at the positions of the particles
 //! @param poss The positions of the particles
+//! @param psi The wavefunction evaluated at the positions of the particles
+//! @param scratch The work space passed to the laplacians
 //! @return The local energy
-template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Laplacian, class Potential>
-Energy LocalEnergyAnalytic_(Wavefunction const &wavef, VarParams<V> params,
-                            Laplacians<N, Laplacian> const &lapls, Masses<N> masses, Potential const &pot,
-                            Positions<D, N> poss) {
-    static_assert(IsWavefunction<D, N, V, Wavefunction>());
+template <Dimension D, ParticNum N, VarParNum V, class Laplacian>
+Energy LocalEnergyAnalytic_(VarParams<V> params, Laplacians<N, Laplacian> const &lapls, Masses<N> masses,
+                            FPType potEnergy, Positions<D, N> const &poss, FPType psi,
+                            Scratch<D, N> &scratch) {
     static_assert(IsWavefunctionDerivative<D, N, V, Laplacian>());
-    static_assert(IsPotential<D, N, Potential>());
 
+    FPType const weightedLaplSum = std::inner_product(
+        lapls.begin(), lapls.end(), masses.begin(), FPType{0}, std::plus<>(),
+        [&poss, params, &scratch](Laplacian const &l, Mass m) {
+            return EvalDerivative_<D, N, V>(l, poss, params, scratch) / m.val;
+        });
+    return Energy{-hbar * hbar * weightedLaplSum / (2 * psi) + potEnergy};
+}
+
+//! @brief Computes the local energy from the laplacians given by a fused evaluator
+//! @param params The variational parameters
+//! @param fused The fused evaluator
+//! @param masses The masses of the particles
+//! @param potEnergy The potential evaluated at the positions of the particles
+//! @param poss The positions of the particles
+//! @param psi The wavefunction evaluated at the positions of the particles
+//! @param scratch The work space passed to the fused evaluator
+//! @return The local energy
+template <Dimension D, ParticNum N, VarParNum V, class FusedEvaluator>
+    requires(IsFusedEvaluator<D, N, V, FusedEvaluator>())
+Energy LocalEnergyAnalytic_(VarParams<V> params, FusedEvaluator const &fused, Masses<N> masses,
+                            FPType potEnergy, Positions<D, N> const &poss, FPType psi,
+                            Scratch<D, N> &scratch) {
+    std::array<FPType, N> const lapls = EvalFused_<D, N, V>(fused, poss, params, scratch).laplacians;
     FPType const weightedLaplSum =
         std::inner_product(lapls.begin(), lapls.end(), masses.begin(), FPType{0}, std::plus<>(),
-                           [&poss, params](Laplacian const &l, Mass m) { return l(poss, params) / m.val; });
-    return Energy{-hbar * hbar * weightedLaplSum / (2 * wavef(poss, params)) + pot(poss)};
+                           [](FPType l, Mass m) { return l / m.val; });
+    return Energy{-hbar * hbar * weightedLaplSum / (2 * psi) + potEnergy};
 }
 
 //! @brief Computes the local energy by numerically estimating the derivative of the wavefunction
@@ -280,40 +415,38 @@ Energy LocalEnergyAnalytic_(Wavefunction const &wavef, VarParams<V> params,
 //! @param params The variational parameters
 //! @param step The step used is the numerical estimation of the derivative
 //! @param masses The masses of the particles
-//! @param pot The potential
-//! @param poss The positions of the particles
+//! @param potEnergy The potential evaluated at the positions of the particles
+//! @param poss The positions of the particles, displaced in place during the computation and restored
+//! before returning
+//! @param psi The wavefunction evaluated at the positions of the particles
 //! @return The local energy
-template <Dimension D, ParticNum N, VarParNum V, class Wavefunction, class Potential>
+template <Dimension D, ParticNum N, VarParNum V, class Wavefunction>
 Energy LocalEnergyNumeric_(Wavefunction const &wavef, VarParams<V> params, FPType step, Masses<N> masses,
-                           Potential const &pot, Positions<D, N> poss) {
+                           FPType potEnergy, Positions<D, N> &poss, FPType psi) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
-    static_assert(IsPotential<D, N, Potential>());
 
-    Energy result{pot(poss)};
-    std::mutex m;
-    auto const indices = std::ranges::views::iota(VarParNum{0u}, N);
-    std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), [&](ParticNum n) {
+    // Coefficients of the numerical second derivative correct up to O(step^9), the i-th for a shift of
+    // (i - 4) steps
+    constexpr std::array<FPType, 9> coeffs{FPType{-1} / 560, FPType{8} / 315, FPType{-1} / 5,
+                                           FPType{8} / 5,    FPType{-205} / 72, FPType{8} / 5,
+                                           FPType{-1} / 5,   FPType{8} / 315, FPType{-1} / 560};
+
+    Energy result{potEnergy};
+    auto const psiFunc{[&wavef, params](Positions<D, N> const &p) { return wavef(p, params); }};
+    // The positions are modified in place, so the particles must be visited sequentially
+    for (ParticNum n = 0u; n != N; ++n) {
         for (Dimension d = 0u; d != D; ++d) {
-            // Numerical derivative correct up to O(step^9)
-            Energy const temp =
-                Energy{-hbar * hbar / (2 * masses[n].val) *
-                       (FPType{-1} / 560 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-4 * step}), params) +
-                        FPType{8} / 315 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-3 * step}), params) +
-                        FPType{-1} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-2 * step}), params) +
-                        FPType{8} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{-step}), params) +
-                        FPType{-205} / 72 * wavef(poss, params) +
-                        FPType{8} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{step}), params) +
-                        FPType{-1} / 5 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{2 * step}), params) +
-                        FPType{8} / 315 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{3 * step}), params) +
-                        FPType{-1} / 560 * wavef(MoveBy_<D, N>(poss, d, n, Coordinate{4 * step}), params)) /
-                       (std::pow(step, 2) * wavef(poss, params))};
-
-            {
-                std::lock_guard<std::mutex> l(m);
-                result += temp;
+            FPType secondDerivative = coeffs[4] * psi;
+            for (IntType k = -4; k != 5; ++k) {
+                if (k != 0) {
+                    Coordinate const delta{static_cast<FPType>(k) * step};
+                    secondDerivative += coeffs[static_cast<UIntType>(k + 4)] *
+                                        EvalDisplaced_<D, N>(poss, n, d, delta, psiFunc);
+                }
             }
+            result += Energy{-hbar * hbar / (2 * masses[n].val) * secondDerivative / (step * step * psi)};
         }
-    });
+    }
 
     return result;
 }
@@ -325,40 +458,40 @@ Energy LocalEnergyNumeric_(Wavefunction const &wavef, VarParams<V> params, FPTyp
 //! @param oldLEPs The local energies to be reweighted, and the positions of the particles when each one was
 //! computed
 //! @param step How much one parameter should be moved
+//! @param resource Where the temporary vectors are allocated
 //! @return The mean energy after reweighting
 //!
 //! Used to compute the gradient of the VMC energy in parameter space
 //! @see VMCRBestParams
 template <Dimension D, ParticNum N, VarParNum V, class Wavefunction>
 std::array<Energy, V> ReweightedEnergies_(Wavefunction const &wavef, VarParams<V> oldParams,
-                                          std::vector<LocEnAndPoss<D, N>> oldLEPs, FPType step) {
+                                          std::vector<LocEnAndPoss<D, N>> const &oldLEPs, FPType step,
+                                          std::pmr::memory_resource *resource) {
     static_assert(IsWavefunction<D, N, V, Wavefunction>());
 
     std::array<Energy, V> result;
     std::generate_n(result.begin(), V, [&, v = VarParNum{0u}]() mutable {
         VarParams<V> newParams = oldParams;
         newParams[v] += VarParam{step};
-        std::vector<Energy> reweightedLocEns(oldLEPs.size());
-        std::transform(
-            std::execution::par_unseq, oldLEPs.begin(), oldLEPs.end(), reweightedLocEns.begin(),
-            [&wavef, newParams, oldParams](LocEnAndPoss<D, N> const &lep) {
-                return Energy{std::pow(wavef(lep.positions, newParams) / wavef(lep.positions, oldParams), 2) *
-                              lep.localEn.val};
-            });
-        std::vector<FPType> denomAddends(oldLEPs.size());
-        std::transform(std::execution::par_unseq, oldLEPs.begin(), oldLEPs.end(), denomAddends.begin(),
-                       [&wavef, newParams, oldParams](LocEnAndPoss<D, N> const &lep) {
-                           return std::pow(wavef(lep.positions, newParams) / wavef(lep.positions, oldParams),
-                                           2);
-                       });
-
-        Energy const num = std::reduce(std::execution::par_unseq, reweightedLocEns.begin(),
-                                       reweightedLocEns.end(), Energy{0}, std::plus<>());
-        FPType const den = std::reduce(std::execution::par_unseq, denomAddends.begin(), denomAddends.end(),
-                                       FPType{0}, std::plus<>());
+        // The weights are accumulated in 'AccumType', even with a narrower wavefunction type
+        auto const weight{[&wavef, newParams, oldParams](LocEnAndPoss<D, N> const &lep) {
+            AccumType const ratio = static_cast<AccumType>(wavef(lep.positions, newParams)) /
+                                    static_cast<AccumType>(wavef(lep.positions, oldParams));
+            return ratio * ratio;
+        }};
+        // The wavefunction is evaluated in parallel, once per configuration and set of parameters
+        std::pmr::vector<AccumType> weights(oldLEPs.size(), resource);
+        std::transform(std::execution::par_unseq, oldLEPs.begin(), oldLEPs.end(), weights.begin(), weight);
+        std::pmr::vector<AccumType> reweightedLocEns(oldLEPs.size(), resource);
+        std::transform(oldLEPs.begin(), oldLEPs.end(), weights.begin(), reweightedLocEns.begin(),
+                       [](LocEnAndPoss<D, N> const &lep, AccumType w) { return w * lep.localEn.val; });
+
+        auto const identity{[](AccumType x) { return x; }};
+        AccumType const num = SumOver_(std::span<AccumType const>{reweightedLocEns}, identity);
+        AccumType const den = SumOver_(std::span<AccumType const>{weights}, identity);
 
         ++v;
-        return num / den;
+        return Energy{num / den};
     });
     return result;
 }
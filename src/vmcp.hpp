@@ -10,8 +10,16 @@
 #ifndef VMCPROJECT_VMCP_HPP
 #define VMCPROJECT_VMCP_HPP
 
+#include "alloctrack.hpp"
+#include "arena.hpp"
+#include "dispatch.hpp"
+#include "layout.hpp"
+#include "potential.hpp"
+#include "radialtable.hpp"
+#include "simdpack.hpp"
 #include "statistics.hpp"
 #include "types.hpp"
+#include "vecmath.hpp"
 #include "vmcalgs.hpp"
 
 #endif
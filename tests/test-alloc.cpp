@@ -0,0 +1,103 @@
+//!
+//! @file test-alloc.cpp
+//! @brief Tests that the sampling loop does not allocate
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! Always built with the allocation tracking, see CMakeLists.txt.
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <vector>
+
+namespace {
+
+constexpr vmcp::Dimension D = 2;
+constexpr vmcp::ParticNum N = 2;
+
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return std::exp(-alpha[0].val * vmcp::WeightedSquaredNorm<D, N>(x, {1, 1}));
+    }
+};
+// Uses the scratch space for its temporaries, as a user derivative that needs some would
+struct FirstDer {
+    vmcp::Dimension dimension;
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha,
+                            vmcp::Scratch<D, N> &scratch) const {
+        std::array<vmcp::FPType, D> &grad = scratch.vectors[0];
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            grad[d] = -2 * alpha[0].val * x[particle][d].val;
+        }
+        return grad[dimension] * Wavef{}(x, alpha);
+    }
+};
+struct Lapl {
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const a = alpha[0].val;
+        vmcp::FPType const sqrdNorm = vmcp::WeightedSquaredNorm<D>(x[particle], {1, 1});
+        return (4 * a * a * sqrdNorm - 2 * a * D) * Wavef{}(x, alpha);
+    }
+};
+struct Pot {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x) const {
+        return vmcp::WeightedSquaredNorm<D, N>(x, {1, 1}) / 2;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Testing the allocations of the sampling loop") {
+    constexpr vmcp::IntType energies = 1 << 6;
+
+    vmcp::RandomGenerator gen{seed};
+    Wavef const wavef;
+    Pot const pot;
+    vmcp::VarParams<1> const params{vmcp::VarParam{0.5f}};
+    vmcp::Gradients<D, N, FirstDer> grads;
+    vmcp::Laplacians<N, Lapl> lapls;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        lapls[n] = Lapl{n};
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            grads[n][d] = FirstDer{d, n};
+        }
+    }
+    vmcp::Masses<N> masses;
+    masses.fill(vmcp::Mass{1});
+    vmcp::CoordBounds<D> bounds;
+    bounds.fill(vmcp::Bound{vmcp::Coordinate{-5}, vmcp::Coordinate{5}});
+    vmcp::Positions<D, N> const startPoss{{{vmcp::Coordinate{0.1f}, vmcp::Coordinate{0.2f}},
+                                           {vmcp::Coordinate{-0.3f}, vmcp::Coordinate{0.1f}}}};
+
+    SUBCASE("The phases are counted") {
+        vmcp::ResetAllocationCounts();
+        {
+            vmcp::PhaseGuard_ const statistics{vmcp::AllocPhase::statistics};
+            std::vector<vmcp::FPType> const v(energies);
+            CHECK(v.size() == energies);
+        }
+        CHECK(vmcp::AllocationCount(vmcp::AllocPhase::statistics) == 1);
+    }
+
+    SUBCASE("Sampling does not allocate") {
+        vmcp::ResetAllocationCounts();
+        std::vector<vmcp::LocEnAndPoss<D, N>> const metropolis = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            wavef, startPoss, params, lapls, masses, pot, bounds, energies, gen);
+        std::vector<vmcp::LocEnAndPoss<D, N>> const impSamp = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            wavef, startPoss, params, grads, lapls, masses, pot, bounds, energies, gen);
+        std::vector<vmcp::LocEnAndPoss<D, N>> const numeric = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            wavef, startPoss, params, true, vmcp::FPType{1e-4f}, masses, pot, bounds, energies, gen);
+        CHECK(metropolis.size() == energies);
+        CHECK(impSamp.size() == energies);
+        CHECK(numeric.size() == energies);
+        CHECK(vmcp::AllocationCount(vmcp::AllocPhase::burnIn) == 0);
+        CHECK(vmcp::AllocationCount(vmcp::AllocPhase::sweep) == 0);
+        CHECK(vmcp::AllocationCount(vmcp::AllocPhase::measurement) == 0);
+    }
+}
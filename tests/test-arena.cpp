@@ -0,0 +1,52 @@
+//!
+//! @file test-arena.cpp
+//! @brief Tests for the arena used by the temporaries of each iteration
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+TEST_CASE("Testing the iteration arena") {
+    constexpr vmcp::IntType numPoints = 1 << 10;
+
+    vmcp::RandomGenerator gen{seed};
+    std::normal_distribution<vmcp::FPType> dist(0, 1);
+    std::vector<vmcp::LocEnAndPoss<1, 1>> data(numPoints);
+    for (vmcp::LocEnAndPoss<1, 1> &lep : data) {
+        lep.localEn = vmcp::Energy{dist(gen)};
+    }
+
+    SUBCASE("Steady state does not use the heap") {
+        // Deliberately too small, so that the first iteration needs the heap
+        vmcp::IterationArena arena{64};
+        std::size_t const iterationSize = 1 << 12;
+        for (vmcp::IntType i = 0; i != 4; ++i) {
+            arena.Reset();
+            std::pmr::vector<vmcp::FPType> first(iterationSize, arena.Resource());
+            std::pmr::vector<vmcp::Energy> second(iterationSize, arena.Resource());
+            if (i == 0) {
+                CHECK(arena.HeapBytes() > 0);
+            } else {
+                CHECK(arena.HeapBytes() == 0);
+            }
+        }
+        CHECK(arena.Capacity() >= iterationSize * (sizeof(vmcp::FPType) + sizeof(vmcp::Energy)));
+    }
+
+    SUBCASE("Statistics do not depend on where the temporaries live") {
+        vmcp::IterationArena arena;
+        for (vmcp::StatFuncType function : {vmcp::StatFuncType::blocking, vmcp::StatFuncType::bootstrap}) {
+            vmcp::RandomGenerator heapGen{seed};
+            vmcp::RandomGenerator arenaGen{seed};
+            arena.Reset();
+            vmcp::Energy const onHeap = vmcp::ErrorOnAvg(data, function, bootstrapSamples, heapGen);
+            vmcp::Energy const onArena =
+                vmcp::ErrorOnAvg(data, function, bootstrapSamples, arenaGen, arena.Resource());
+            CHECK(onHeap.val == onArena.val);
+        }
+    }
+}
@@ -34,7 +34,7 @@ TEST_CASE("Testing the potential box") {
         SUBCASE("No variational parameters") {
             struct WavefBox {
                 vmcp::FPType l;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     if (std::abs(x[0][0].val) <= l / 2) {
                         return std::cos(std::numbers::pi_v<vmcp::FPType> * x[0][0].val / l);
                     } else {
@@ -44,7 +44,7 @@ TEST_CASE("Testing the potential box") {
             };
             struct FirstDerBox {
                 vmcp::FPType l;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     if (std::abs(x[0][0].val) <= l / 2) {
                         return -std::numbers::pi_v<vmcp::FPType> / l *
                                std::sin(std::numbers::pi_v<vmcp::FPType> * x[0][0].val / l);
@@ -55,7 +55,7 @@ TEST_CASE("Testing the potential box") {
             };
             struct LaplBox {
                 vmcp::FPType l;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     if (std::abs(x[0][0].val) <= l / 2) {
                         return -std::pow(std::numbers::pi_v<vmcp::FPType> / l, 2) *
                                std::cos(std::numbers::pi_v<vmcp::FPType> * x[0][0].val / l);
@@ -0,0 +1,75 @@
+//!
+//! @file test-dispatch.cpp
+//! @brief Tests the runtime selection of the multiversioned kernels
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("Testing the dispatch of the kernels") {
+    SUBCASE("The active level is supported by the CPU") {
+        vmcp::ISALevel const level = vmcp::ActiveISALevel();
+#if VMCP_MULTIVERSION_ENABLED
+        if (level == vmcp::ISALevel::avx512) {
+            CHECK(__builtin_cpu_supports("avx512f"));
+        }
+        if (level != vmcp::ISALevel::baseline) {
+            CHECK(__builtin_cpu_supports("avx2"));
+            CHECK(__builtin_cpu_supports("fma"));
+        }
+#else
+        CHECK(level == vmcp::ISALevel::baseline);
+#endif
+        std::ostringstream report;
+        vmcp::PrintCPUFeatures(report);
+        CHECK(report.str().find(vmcp::ISALevelName(level)) != std::string::npos);
+    }
+
+    SUBCASE("The multiversioned kernels match a plain evaluation") {
+        constexpr vmcp::Dimension D = 3;
+        constexpr vmcp::ParticNum N = 13;
+        vmcp::RandomGenerator gen{seed};
+        std::normal_distribution<vmcp::FPType> normal(0, 1);
+        vmcp::Positions<D, N> poss;
+        for (vmcp::Position<D> &p : poss) {
+            for (vmcp::Coordinate &c : p) {
+                c = vmcp::Coordinate{normal(gen)};
+            }
+        }
+        std::array<vmcp::FPType, D> const weights{1, 2, 3};
+        vmcp::FPType expected = 0;
+        for (vmcp::Position<D> const &p : poss) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                expected += weights[d] * p[d].val * p[d].val;
+            }
+        }
+        vmcp::FPType const tolerance = 100 * std::numeric_limits<vmcp::FPType>::epsilon() * expected;
+        CHECK(std::abs(vmcp::WeightedSquaredNorm<D, N>(poss, weights) - expected) <= tolerance);
+        vmcp::SoAPositions<D, N> const soaPoss{poss};
+        CHECK(std::abs(vmcp::WeightedSquaredNorm<D, N>(soaPoss, weights) - expected) <= tolerance);
+
+        // Not a multiple of the number of lanes, so that the remainder loop runs too
+        std::vector<vmcp::AccumType> values(1001);
+        vmcp::AccumType plainSum = 0;
+        for (vmcp::AccumType &v : values) {
+            v = static_cast<vmcp::AccumType>(normal(gen));
+            plainSum += v;
+        }
+        vmcp::AccumType const sum =
+            vmcp::SumOver_(std::span<vmcp::AccumType const>{values}, [](vmcp::AccumType x) { return x; });
+        CHECK(std::abs(sum - plainSum) <= 1e-12);
+    }
+}
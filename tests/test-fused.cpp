@@ -0,0 +1,131 @@
+//!
+//! @file test-fused.cpp
+//! @brief Tests that a fused evaluator gives the same results as the separate gradients and laplacians
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr vmcp::Dimension D = 2;
+constexpr vmcp::ParticNum N = 3;
+constexpr vmcp::FPType fusedTolerance = 1e-4f;
+
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return std::exp(-alpha[0].val * vmcp::WeightedSquaredNorm<D, N>(x, {1, 2}));
+    }
+};
+struct FirstDer {
+    vmcp::Dimension dimension;
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const weight = dimension == 0 ? 1 : 2;
+        return -2 * alpha[0].val * weight * x[particle][dimension].val * Wavef{}(x, alpha);
+    }
+};
+struct Lapl {
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const a = alpha[0].val;
+        vmcp::FPType const sqrdNorm = vmcp::WeightedSquaredNorm<D>(x[particle], {1, 4});
+        return (4 * a * a * sqrdNorm - 2 * a * 3) * Wavef{}(x, alpha);
+    }
+};
+// Shares the exponential between the wavefunction and all of the derivatives
+struct Fused {
+    vmcp::FusedDerivatives<D, N> operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const a = alpha[0].val;
+        vmcp::FusedDerivatives<D, N> result;
+        result.psi = Wavef{}(x, alpha);
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            result.gradient[n] = {-2 * a * x[n][0].val * result.psi, -4 * a * x[n][1].val * result.psi};
+            vmcp::FPType const sqrdNorm = vmcp::WeightedSquaredNorm<D>(x[n], {1, 4});
+            result.laplacians[n] = (4 * a * a * sqrdNorm - 2 * a * 3) * result.psi;
+        }
+        return result;
+    }
+};
+struct Pot {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x) const {
+        return vmcp::WeightedSquaredNorm<D, N>(x, {1, 4}) / 2;
+    }
+};
+
+bool Close(vmcp::FPType x, vmcp::FPType y) {
+    return std::abs(x - y) <= fusedTolerance * (std::abs(y) + 1);
+}
+
+} // namespace
+
+TEST_CASE("Testing the fused evaluators") {
+    static_assert(vmcp::IsFusedEvaluator<D, N, 1, Fused>());
+    static_assert(!vmcp::IsFusedEvaluator<D, N, 1, Lapl>());
+
+    vmcp::RandomGenerator gen{seed};
+    vmcp::VarParams<1> const params{vmcp::VarParam{0.6f}};
+    vmcp::Gradients<D, N, FirstDer> grads;
+    vmcp::Laplacians<N, Lapl> lapls;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        lapls[n] = Lapl{n};
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            grads[n][d] = FirstDer{d, n};
+        }
+    }
+    vmcp::Masses<N> const masses{vmcp::Mass{1}, vmcp::Mass{2}, vmcp::Mass{0.5f}};
+    vmcp::CoordBounds<D> bounds;
+    bounds.fill(vmcp::Bound{vmcp::Coordinate{-5}, vmcp::Coordinate{5}});
+    vmcp::Positions<D, N> startPoss;
+    std::normal_distribution<vmcp::FPType> normal(0, 1);
+    for (vmcp::Position<D> &p : startPoss) {
+        p = {vmcp::Coordinate{normal(gen)}, vmcp::Coordinate{normal(gen)}};
+    }
+
+    SUBCASE("Local energy and drift force") {
+        vmcp::FPType const psi = Wavef{}(startPoss, params);
+        vmcp::Scratch<D, N> scratch;
+        vmcp::FPType const potEnergy = Pot{}(startPoss);
+        vmcp::Energy const separate = vmcp::LocalEnergyAnalytic_<D, N, 1>(params, lapls, masses, potEnergy,
+                                                                          startPoss, psi, scratch);
+        vmcp::Energy const fused = vmcp::LocalEnergyAnalytic_<D, N, 1>(params, Fused{}, masses, potEnergy,
+                                                                       startPoss, psi, scratch);
+        CHECK(Close(fused.val, separate.val));
+
+        vmcp::DriftForce<D, N> const separateForce =
+            vmcp::DriftForceAnalytic_<D, N, 1>(startPoss, psi, params, grads, scratch);
+        vmcp::DriftForce<D, N> const fusedForce =
+            vmcp::DriftForceAnalytic_<D, N, 1>(startPoss, psi, params, Fused{}, scratch);
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                CHECK(Close(fusedForce[n][d], separateForce[n][d]));
+            }
+        }
+    }
+
+    SUBCASE("Sampling") {
+        constexpr vmcp::IntType energies = 1 << 7;
+        vmcp::RandomGenerator separateGen{seed};
+        vmcp::RandomGenerator fusedGen{seed};
+        // The Metropolis moves do not depend on the derivatives, so the same configurations are sampled
+        std::vector<vmcp::LocEnAndPoss<D, N>> const separate = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            Wavef{}, startPoss, params, lapls, masses, Pot{}, bounds, energies, separateGen);
+        std::vector<vmcp::LocEnAndPoss<D, N>> const fused = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            Wavef{}, startPoss, params, Fused{}, false, masses, Pot{}, bounds, energies, fusedGen);
+        REQUIRE(fused.size() == separate.size());
+        for (std::size_t i = 0; i != fused.size(); ++i) {
+            CHECK(Close(fused[i].localEn.val, separate[i].localEn.val));
+        }
+
+        std::vector<vmcp::LocEnAndPoss<D, N>> const impSamp = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            Wavef{}, startPoss, params, Fused{}, true, masses, Pot{}, bounds, energies, fusedGen);
+        CHECK(impSamp.size() == energies);
+    }
+}
@@ -32,7 +32,7 @@ TEST_CASE("Testing the harmonic oscillator") {
         struct PotHO {
             vmcp::Mass m;
             vmcp::FPType omega;
-            vmcp::FPType operator()(vmcp::Positions<1, 1> x) const {
+            vmcp::FPType operator()(vmcp::Positions<1, 1> const &x) const {
                 return x[0][0].val * x[0][0].val * m.val * omega * omega / 2;
             }
         };
@@ -42,14 +42,14 @@ TEST_CASE("Testing the harmonic oscillator") {
             struct WavefHO {
                 vmcp::Mass m;
                 vmcp::FPType omega;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     return std::exp(-x[0][0].val * x[0][0].val * m.val * omega / (2 * vmcp::hbar));
                 }
             };
             struct FirstDerHO {
                 vmcp::Mass m;
                 vmcp::FPType omega;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     return -x[0][0].val * m.val * omega / vmcp::hbar *
                            WavefHO{m, omega}(x, vmcp::VarParams<0>{});
                 }
@@ -57,7 +57,7 @@ TEST_CASE("Testing the harmonic oscillator") {
             struct LaplHO {
                 vmcp::Mass m;
                 vmcp::FPType omega;
-                vmcp::FPType operator()(vmcp::Positions<1, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 1> const &x, vmcp::VarParams<0>) const {
                     return (std::pow(x[0][0].val * m.val * omega / vmcp::hbar, 2) -
                             m.val * omega / vmcp::hbar) *
                            WavefHO{m, omega}(x, vmcp::VarParams<0>{});
@@ -143,10 +143,10 @@ TEST_CASE("Testing the harmonic oscillator") {
 
         SUBCASE("One variational parameter") {
             PotHO potHO{mInit[0], omegaInit};
-            auto const wavefHO{[](vmcp::Positions<1, 1> x, vmcp::VarParams<1> alpha) {
+            auto const wavefHO{[](vmcp::Positions<1, 1> const &x, vmcp::VarParams<1> alpha) {
                 return std::exp(-alpha[0].val * x[0][0].val * x[0][0].val / 2);
             }};
-            std::array const laplHO{[](vmcp::Positions<1, 1> x, vmcp::VarParams<1> alpha) {
+            std::array const laplHO{[](vmcp::Positions<1, 1> const &x, vmcp::VarParams<1> alpha) {
                 return (std::pow(x[0][0].val * alpha[0].val, 2) - alpha[0].val) *
                        std::exp(-alpha[0].val * x[0][0].val * x[0][0].val / 2);
             }};
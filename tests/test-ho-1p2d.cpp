@@ -32,7 +32,7 @@ TEST_CASE("Testing the harmonic oscillator") {
         struct PotHO {
             vmcp::Mass m;
             vmcp::FPType omega;
-            vmcp::FPType operator()(vmcp::Positions<2, 1> x) const {
+            vmcp::FPType operator()(vmcp::Positions<2, 1> const &x) const {
                 return (std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) * m.val * omega * omega / 2;
             }
         };
@@ -42,7 +42,7 @@ TEST_CASE("Testing the harmonic oscillator") {
             struct WavefHO {
                 vmcp::Mass m;
                 vmcp::FPType omega;
-                vmcp::FPType operator()(vmcp::Positions<2, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<2, 1> const &x, vmcp::VarParams<0>) const {
                     return std::exp(-(std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) * m.val * omega /
                                     (2 * vmcp::hbar));
                 }
@@ -56,7 +56,7 @@ TEST_CASE("Testing the harmonic oscillator") {
                     assert(dimension >= 0);
                     assert(dimension <= 1);
                 }
-                vmcp::FPType operator()(vmcp::Positions<2, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<2, 1> const &x, vmcp::VarParams<0>) const {
                     vmcp::UIntType uDim = static_cast<vmcp::UIntType>(dimension);
                     return -x[0][uDim].val * m.val * omega / vmcp::hbar *
                            WavefHO{m, omega}(x, vmcp::VarParams<0>{});
@@ -65,7 +65,7 @@ TEST_CASE("Testing the harmonic oscillator") {
             struct LaplHO {
                 vmcp::Mass m;
                 vmcp::FPType omega;
-                vmcp::FPType operator()(vmcp::Positions<2, 1> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<2, 1> const &x, vmcp::VarParams<0>) const {
                     return (m.val * omega / vmcp::hbar *
                                 (std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) -
                             2) *
@@ -154,10 +154,10 @@ TEST_CASE("Testing the harmonic oscillator") {
 
         SUBCASE("One variational parameter") {
             PotHO potHO{mInit[0], omegaInit};
-            auto const wavefHO{[](vmcp::Positions<2, 1> x, vmcp::VarParams<1> alpha) {
+            auto const wavefHO{[](vmcp::Positions<2, 1> const &x, vmcp::VarParams<1> alpha) {
                 return std::exp(-alpha[0].val * (std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) / 2);
             }};
-            std::array const laplHO{[](vmcp::Positions<2, 1> x, vmcp::VarParams<1> alpha) {
+            std::array const laplHO{[](vmcp::Positions<2, 1> const &x, vmcp::VarParams<1> alpha) {
                 return (alpha[0].val * (std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) - 2) *
                        alpha[0].val *
                        std::exp(-alpha[0].val * (std::pow(x[0][0].val, 2) + std::pow(x[0][1].val, 2)) / 2);
@@ -38,7 +38,7 @@ TEST_CASE("Testing the harmonic oscillator") {
         struct PotHO {
             std::array<vmcp::Mass, 2> m;
             std::array<vmcp::FPType, 2> omega;
-            vmcp::FPType operator()(vmcp::Positions<1, 2> x) const {
+            vmcp::FPType operator()(vmcp::Positions<1, 2> const &x) const {
                 return x[0][0].val * x[0][0].val * (m[0].val * omega[0] * omega[0] / 2) +
                        x[1][0].val * x[1][0].val * (m[1].val * omega[1] * omega[1] / 2);
             }
@@ -49,7 +49,7 @@ TEST_CASE("Testing the harmonic oscillator") {
             struct WavefHO {
                 std::array<vmcp::Mass, 2> m;
                 std::array<vmcp::FPType, 2> omega;
-                vmcp::FPType operator()(vmcp::Positions<1, 2> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 2> const &x, vmcp::VarParams<0>) const {
                     return std::exp(-(x[0][0].val * x[0][0].val * m[0].val * omega[0] +
                                       x[1][0].val * x[1][0].val * m[1].val * omega[1]) /
                                     (2 * vmcp::hbar));
@@ -65,7 +65,7 @@ TEST_CASE("Testing the harmonic oscillator") {
                     assert(particle >= 0);
                     assert(particle <= 1);
                 }
-                vmcp::FPType operator()(vmcp::Positions<1, 2> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 2> const &x, vmcp::VarParams<0>) const {
                     vmcp::UIntType uPar = static_cast<vmcp::UIntType>(particle);
                     return -x[uPar][0].val * m[uPar].val * omega[uPar] / vmcp::hbar *
                            WavefHO{m, omega}(x, vmcp::VarParams<0>{});
@@ -81,7 +81,7 @@ TEST_CASE("Testing the harmonic oscillator") {
                     assert(particle >= 0);
                     assert(particle <= 1);
                 }
-                vmcp::FPType operator()(vmcp::Positions<1, 2> x, vmcp::VarParams<0>) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 2> const &x, vmcp::VarParams<0>) const {
                     vmcp::UIntType uPar = static_cast<vmcp::UIntType>(particle);
                     return (std::pow(x[uPar][0].val * m[uPar].val * omega[uPar] / vmcp::hbar, 2) -
                             m[uPar].val * omega[uPar] / vmcp::hbar) *
@@ -179,7 +179,7 @@ TEST_CASE("Testing the harmonic oscillator") {
                     assert(particle >= 0);
                     assert(particle <= 1);
                 }
-                vmcp::FPType operator()(vmcp::Positions<1, 2> x, vmcp::VarParams<1> alpha) const {
+                vmcp::FPType operator()(vmcp::Positions<1, 2> const &x, vmcp::VarParams<1> alpha) const {
                     vmcp::UIntType uPar = static_cast<vmcp::UIntType>(particle);
                     return (std::pow(x[uPar][0].val * alpha[0].val, 2) - alpha[0].val) *
                            std::exp(-alpha[0].val * (x[0][0].val * x[0][0].val + x[1][0].val * x[1][0].val) /
@@ -187,7 +187,7 @@ TEST_CASE("Testing the harmonic oscillator") {
                 }
             };
             PotHO potHO{mInitVP, omegaInitVP};
-            auto const wavefHO{[](vmcp::Positions<1, 2> x, vmcp::VarParams<1> alpha) {
+            auto const wavefHO{[](vmcp::Positions<1, 2> const &x, vmcp::VarParams<1> alpha) {
                 return std::exp(-alpha[0].val * (x[0][0].val * x[0][0].val + x[1][0].val * x[1][0].val) / 2);
             }};
             vmcp::Laplacians<2, LaplHO> const laplsHO{LaplHO{0}, LaplHO{1}};
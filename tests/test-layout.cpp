@@ -0,0 +1,126 @@
+//!
+//! @file test-layout.cpp
+//! @brief Tests for the structure-of-arrays positions and the layout kernels
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cstdint>
+
+TEST_CASE("Testing the structure-of-arrays layout") {
+    constexpr vmcp::FPType layoutTolerance = 1e-12f;
+    constexpr vmcp::Dimension D = 3;
+    constexpr vmcp::ParticNum N = 5;
+
+    vmcp::RandomGenerator gen{seed};
+    std::uniform_real_distribution<vmcp::FPType> unif(-10, 10);
+    vmcp::Positions<D, N> poss;
+    for (vmcp::Position<D> &p : poss) {
+        for (vmcp::Coordinate &c : p) {
+            c.val = unif(gen);
+        }
+    }
+    vmcp::SoAPositions<D, N> const soaPoss{poss};
+
+    SUBCASE("Alignment and padding") {
+        CHECK((vmcp::SoAPositions<D, N>::paddedN % vmcp::simdLanes) == 0);
+        CHECK(vmcp::SoAPositions<D, N>::paddedN >= N);
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            CHECK((reinterpret_cast<std::uintptr_t>(soaPoss.Axis(d)) % vmcp::simdAlignment) == 0);
+            for (vmcp::ParticNum n = N; n != vmcp::SoAPositions<D, N>::paddedN; ++n) {
+                CHECK(soaPoss.Axis(d)[n] == vmcp::FPType{0});
+            }
+        }
+    }
+
+    SUBCASE("Conversion between layouts") {
+        vmcp::Positions<D, N> const converted = soaPoss.ToPositions();
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                CHECK(converted[n][d].val == poss[n][d].val);
+                CHECK(soaPoss.Get(n, d).val == poss[n][d].val);
+            }
+        }
+    }
+
+    SUBCASE("Weighted squared norm") {
+        std::array<vmcp::FPType, D> const weights{1, 2, 3};
+        vmcp::FPType expected = 0;
+        for (vmcp::Position<D> const &p : poss) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                expected += weights[d] * p[d].val * p[d].val;
+            }
+        }
+        CHECK(std::abs(vmcp::WeightedSquaredNorm<D, N>(poss, weights) - expected) < layoutTolerance);
+        CHECK(std::abs(vmcp::WeightedSquaredNorm<D, N>(soaPoss, weights) - expected) < layoutTolerance);
+    }
+
+    SUBCASE("Squared distances") {
+        std::array<vmcp::FPType, N> aosDists;
+        std::array<vmcp::FPType, vmcp::SoAPositions<D, N>::paddedN> soaDists;
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            vmcp::SquaredDistancesFrom<D, N>(poss, n, aosDists);
+            vmcp::SquaredDistancesFrom<D, N>(soaPoss, n, soaDists);
+            CHECK(aosDists[n] == vmcp::FPType{0});
+            for (vmcp::ParticNum m = 0u; m != N; ++m) {
+                CHECK(std::abs(aosDists[m] - soaDists[m]) < layoutTolerance);
+            }
+        }
+    }
+
+    SUBCASE("Pair kernels") {
+        constexpr vmcp::FPType hardCore = 0.1f;
+        auto const u{[](vmcp::FPType r) { return std::log(1 - hardCore / r); }};
+        auto const pairTerm{[](vmcp::FPType r) {
+            return vmcp::PairTerm{std::log(1 - hardCore / r), hardCore / (r * (r - hardCore)),
+                                  (hardCore * hardCore - 2 * hardCore * r) / std::pow(r * (r - hardCore), 2)};
+        }};
+        std::array<vmcp::FPType, N> dists;
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            vmcp::SquaredDistancesFrom<D, N>(poss, n, dists);
+            vmcp::FPType expectedFollowing = 0;
+            vmcp::PairSums<D> expected{0, {}, 0, false};
+            for (vmcp::ParticNum m = 0u; m != N; ++m) {
+                if (m == n) {
+                    continue;
+                }
+                vmcp::FPType const r = std::sqrt(dists[m]);
+                vmcp::PairTerm const term = pairTerm(r);
+                if (m > n) {
+                    expectedFollowing += u(r);
+                }
+                expected.u += term.u;
+                expected.laplacian += term.uPrime2 + (D - 1) * term.uPrime / r;
+                for (vmcp::Dimension d = 0u; d != D; ++d) {
+                    expected.gradient[d] += term.uPrime * (poss[n][d].val - poss[m][d].val) / r;
+                }
+            }
+
+            vmcp::PairSum const following = vmcp::PairSumFrom<D, N>(soaPoss, n, hardCore, u);
+            CHECK(!following.overlap);
+            CHECK(std::abs(following.u - expectedFollowing) < layoutTolerance);
+            vmcp::PairSums<D> const all = vmcp::PairSumsFrom<D, N>(soaPoss, n, hardCore, pairTerm);
+            CHECK(!all.overlap);
+            CHECK(std::abs(all.u - expected.u) < layoutTolerance);
+            CHECK(std::abs(all.laplacian - expected.laplacian) < layoutTolerance);
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                CHECK(std::abs(all.gradient[d] - expected.gradient[d]) < layoutTolerance);
+            }
+        }
+
+        // Moves the last particle inside the hard core of the second
+        vmcp::Positions<D, N> overlapping = poss;
+        overlapping[N - 1] = overlapping[1];
+        overlapping[N - 1][0].val += hardCore / 2;
+        vmcp::SoAPositions<D, N> const soaOverlapping{overlapping};
+        CHECK(vmcp::PairSumFrom<D, N>(soaOverlapping, 1, hardCore, u).overlap);
+        CHECK(!vmcp::PairSumFrom<D, N>(soaOverlapping, N - 1, hardCore, u).overlap);
+        CHECK(vmcp::PairSumsFrom<D, N>(soaOverlapping, N - 1, hardCore, pairTerm).overlap);
+        CHECK(!vmcp::PairSumsFrom<D, N>(soaOverlapping, 0, hardCore, pairTerm).overlap);
+    }
+}
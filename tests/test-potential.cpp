@@ -0,0 +1,138 @@
+//!
+//! @file test-potential.cpp
+//! @brief Tests for the structured potentials and their incremental tracking
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr vmcp::Dimension D = 3;
+constexpr vmcp::ParticNum N = 4;
+constexpr vmcp::FPType potTolerance = 1e-4f;
+
+struct Trap {
+    vmcp::FPType operator()(vmcp::Position<D> const &x) const {
+        return vmcp::WeightedSquaredNorm<D>(x, {1, 1, 2}) / 2;
+    }
+};
+struct Repulsion {
+    vmcp::FPType operator()(vmcp::FPType r) const { return std::exp(-r * r) / (r + 1); }
+};
+using Structured = vmcp::StructuredPotential<D, N, Trap, Repulsion>;
+
+vmcp::FPType Distance(vmcp::Position<D> const &p, vmcp::Position<D> const &q) {
+    vmcp::FPType sqrdDist = 0;
+    for (vmcp::Dimension d = 0u; d != D; ++d) {
+        sqrdDist += (p[d].val - q[d].val) * (p[d].val - q[d].val);
+    }
+    return std::sqrt(sqrdDist);
+}
+
+// The same potential, as a function of the whole configuration
+struct Monolithic {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x) const {
+        vmcp::FPType result = 0;
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            result += Trap{}(x[n]);
+            for (vmcp::ParticNum m = 0u; m != n; ++m) {
+                result += Repulsion{}(Distance(x[n], x[m]));
+            }
+        }
+        return result;
+    }
+};
+
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return std::exp(-alpha[0].val * vmcp::WeightedSquaredNorm<D, N>(x, {1, 1, 1}));
+    }
+};
+struct Lapl {
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const a = alpha[0].val;
+        vmcp::FPType const sqrdNorm = vmcp::WeightedSquaredNorm<D>(x[particle], {1, 1, 1});
+        return (4 * a * a * sqrdNorm - 2 * a * D) * Wavef{}(x, alpha);
+    }
+};
+
+bool Close(vmcp::FPType x, vmcp::FPType y) { return std::abs(x - y) <= potTolerance * (std::abs(y) + 1); }
+
+bool SamePositions(vmcp::Positions<D, N> const &x, vmcp::Positions<D, N> const &y) {
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            if (x[n][d].val != y[n][d].val) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Testing the structured potentials") {
+    vmcp::RandomGenerator gen{seed};
+    Structured const structured{Trap{}, Repulsion{}};
+    Monolithic const monolithic;
+    vmcp::Positions<D, N> startPoss;
+    std::normal_distribution<vmcp::FPType> normal(0, 1);
+    for (vmcp::Position<D> &p : startPoss) {
+        for (vmcp::Coordinate &c : p) {
+            c = vmcp::Coordinate{normal(gen)};
+        }
+    }
+
+    SUBCASE("Value on the whole configuration") {
+        CHECK(Close(structured(startPoss), monolithic(startPoss)));
+    }
+
+    SUBCASE("The tracked value follows the moves") {
+        vmcp::VarParams<1> const params{vmcp::VarParam{0.5f}};
+        vmcp::WalkerState<D, N> walker = vmcp::MakeWalkerState_<D, N, 1>(Wavef{}, params, startPoss);
+        vmcp::PotentialTracker_<D, N, Structured> tracker{structured, walker.positions};
+        auto const onAccept{[&tracker, &walker](vmcp::ParticNum n, vmcp::Position<D> const &oldPos) {
+            tracker.Moved(walker.positions, n, oldPos);
+        }};
+        vmcp::IntType accepted = 0;
+        for (vmcp::IntType i = 0; i != vmcp::resyncMeasurements_potTracker; ++i) {
+            accepted += vmcp::MetropolisUpdate_<D, N, 1>(Wavef{}, params, walker, 1, gen, onAccept);
+            CHECK(Close(tracker.Value(walker.positions), monolithic(walker.positions)));
+        }
+        CHECK(accepted > 0);
+    }
+
+    SUBCASE("Local energies do not depend on the tracking") {
+        constexpr vmcp::IntType energies = 1 << 8;
+        vmcp::VarParams<1> const params{vmcp::VarParam{0.4f}};
+        vmcp::Laplacians<N, Lapl> lapls;
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            lapls[n] = Lapl{n};
+        }
+        vmcp::Masses<N> masses;
+        masses.fill(vmcp::Mass{1});
+        vmcp::CoordBounds<D> bounds;
+        bounds.fill(vmcp::Bound{vmcp::Coordinate{-5}, vmcp::Coordinate{5}});
+
+        vmcp::RandomGenerator trackedGen{seed};
+        vmcp::RandomGenerator monolithicGen{seed};
+        std::vector<vmcp::LocEnAndPoss<D, N>> const tracked = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            Wavef{}, startPoss, params, lapls, masses, structured, bounds, energies, trackedGen);
+        std::vector<vmcp::LocEnAndPoss<D, N>> const reference = vmcp::VMCLocEnAndPoss<D, N, 1>(
+            Wavef{}, startPoss, params, lapls, masses, monolithic, bounds, energies, monolithicGen);
+        REQUIRE(tracked.size() == reference.size());
+        for (std::size_t i = 0; i != tracked.size(); ++i) {
+            CHECK(SamePositions(tracked[i].positions, reference[i].positions));
+            CHECK(Close(tracked[i].localEn.val, reference[i].localEn.val));
+        }
+    }
+}
@@ -0,0 +1,107 @@
+//!
+//! @file test-precision.cpp
+//! @brief Validates the mixed precision mode against double precision evaluations
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+//! Always built in mixed precision, see CMakeLists.txt.
+//! The samples are drawn in 'float', then every local energy is recomputed in 'double' at the same positions
+//! and the averages are compared with the exact variational energy.
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+constexpr vmcp::Dimension D = 2;
+constexpr vmcp::ParticNum N = 2;
+// Relative difference allowed between a local energy computed in 'float' and in 'double'
+constexpr double mixedTolerance = 1e-5;
+
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return std::exp(-alpha[0].val * vmcp::WeightedSquaredNorm<D, N>(x, {1, 1}));
+    }
+};
+struct Lapl {
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType const a = alpha[0].val;
+        vmcp::FPType const sqrdNorm = vmcp::WeightedSquaredNorm<D>(x[particle], {1, 1});
+        return (4 * a * a * sqrdNorm - 2 * a * D) * Wavef{}(x, alpha);
+    }
+};
+struct Pot {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x) const {
+        return vmcp::WeightedSquaredNorm<D, N>(x, {1, 1}) / 2;
+    }
+};
+
+// The local energy of the gaussian trial wavefunction in a unit harmonic trap, entirely in double precision
+double LocalEnergyDouble(vmcp::Positions<D, N> const &x, double alpha) {
+    double sqrdNorm = 0;
+    for (vmcp::Position<D> const &p : x) {
+        for (vmcp::Coordinate c : p) {
+            sqrdNorm += static_cast<double>(c.val) * static_cast<double>(c.val);
+        }
+    }
+    return alpha * D * N + (0.5 - 2 * alpha * alpha) * sqrdNorm;
+}
+
+} // namespace
+
+TEST_CASE("Testing the mixed precision mode") {
+    static_assert(std::is_same_v<vmcp::FPType, float>);
+    static_assert(std::is_same_v<vmcp::AccumType, double>);
+    static_assert(std::is_same_v<decltype(vmcp::Energy::val), double>);
+
+    constexpr vmcp::IntType energies = 1 << 12;
+    constexpr double alpha = 0.4;
+
+    vmcp::RandomGenerator gen{seed};
+    vmcp::VarParams<1> const params{vmcp::VarParam{static_cast<vmcp::FPType>(alpha)}};
+    vmcp::Laplacians<N, Lapl> lapls;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        lapls[n] = Lapl{n};
+    }
+    vmcp::Masses<N> masses;
+    masses.fill(vmcp::Mass{1});
+    vmcp::CoordBounds<D> bounds;
+    bounds.fill(vmcp::Bound{vmcp::Coordinate{-5}, vmcp::Coordinate{5}});
+    vmcp::Positions<D, N> const startPoss{{{vmcp::Coordinate{0.1f}, vmcp::Coordinate{0.2f}},
+                                           {vmcp::Coordinate{-0.3f}, vmcp::Coordinate{0.1f}}}};
+
+    std::vector<vmcp::LocEnAndPoss<D, N>> const leps = vmcp::VMCLocEnAndPoss<D, N, 1>(
+        Wavef{}, startPoss, params, lapls, masses, Pot{}, bounds, energies, gen);
+    REQUIRE(leps.size() == energies);
+
+    SUBCASE("Each local energy matches its double precision evaluation") {
+        for (vmcp::LocEnAndPoss<D, N> const &lep : leps) {
+            double const reference = LocalEnergyDouble(lep.positions, alpha);
+            CHECK(std::abs(lep.localEn.val - reference) <= mixedTolerance * std::abs(reference));
+        }
+    }
+
+    SUBCASE("The statistics are accumulated in double precision") {
+        std::vector<double> references(leps.size());
+        double referenceSum = 0;
+        for (std::size_t i = 0; i != leps.size(); ++i) {
+            references[i] = leps[i].localEn.val;
+            referenceSum += references[i];
+        }
+        vmcp::Energy const mean = vmcp::Mean(leps);
+        CHECK(std::abs(mean.val - referenceSum / energies) <= 1e-12 * std::abs(mean.val));
+
+        // Exact variational energy of the gaussian trial wavefunction
+        double const exact = D * N * (alpha / 2 + 1 / (8 * alpha));
+        vmcp::Energy const stdDev = vmcp::StdDev(leps);
+        CHECK(std::abs(mean.val - exact) <= allowedStdDevs * stdDev.val);
+    }
+}
@@ -0,0 +1,87 @@
+//!
+//! @file test-radialtable.cpp
+//! @brief Tests the tabulation of the radial functions
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace {
+
+constexpr vmcp::IntType samples_radialTable = 1 << 14;
+
+// The Jastrow factor of hard spheres, as in the interacting harmonic oscillator
+struct HardSphere {
+    vmcp::FPType a;
+    vmcp::PairTerm operator()(vmcp::FPType r) const {
+        vmcp::FPType const rTimesRMinusA = r * (r - a);
+        return vmcp::PairTerm{std::log(1 - a / r), a / rTimesRMinusA,
+                              (a * a - 2 * a * r) / (rTimesRMinusA * rTimesRMinusA)};
+    }
+};
+// A Lennard-Jones potential, with unit depth and size
+struct LennardJones {
+    vmcp::PairTerm operator()(vmcp::FPType r) const {
+        vmcp::FPType const inv6 = 1 / (r * r * r * r * r * r);
+        return vmcp::PairTerm{4 * (inv6 * inv6 - inv6), 4 * (-12 * inv6 * inv6 + 6 * inv6) / r,
+                              4 * (156 * inv6 * inv6 - 42 * inv6) / (r * r)};
+    }
+};
+
+template <class PairFunction>
+vmcp::FPType MaxError(vmcp::RadialTable<PairFunction> const &table, PairFunction const &func,
+                      vmcp::FPType rMin, vmcp::FPType rMax, vmcp::RandomGenerator &gen) {
+    auto const error{[](vmcp::FPType approx, vmcp::FPType exact) {
+        return std::abs(approx - exact) / (std::abs(exact) + 1);
+    }};
+    std::uniform_real_distribution<vmcp::FPType> unif(rMin, rMax);
+    vmcp::FPType result = 0;
+    for (vmcp::IntType i = 0; i != samples_radialTable; ++i) {
+        vmcp::FPType const r = unif(gen);
+        vmcp::PairTerm const exact = func(r);
+        vmcp::PairTerm const approx = table(r);
+        result = std::max({result, error(approx.u, exact.u), error(approx.uPrime, exact.uPrime),
+                           error(approx.uPrime2, exact.uPrime2)});
+        CHECK(table.Value(r) == approx.u);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Testing the radial tables") {
+    vmcp::RandomGenerator gen{seed};
+
+    SUBCASE("Hard spheres") {
+        HardSphere const func{0.01f};
+        vmcp::RadialTable<HardSphere> const table{func, 0.05f, 10};
+        CHECK(table.ErrorBound() <= vmcp::tolerance_radialTable);
+        CHECK(table.Intervals() <= vmcp::maxIntervals_radialTable);
+        CHECK(MaxError(table, func, 0.05f, 10, gen) <= vmcp::tolerance_radialTable);
+    }
+
+    SUBCASE("Lennard-Jones") {
+        LennardJones const func;
+        vmcp::FPType const tolerance = 100 * vmcp::tolerance_radialTable;
+        vmcp::RadialTable<LennardJones> const table{func, 0.9f, 5, tolerance};
+        CHECK(table.ErrorBound() <= tolerance);
+        CHECK(MaxError(table, func, 0.9f, 5, gen) <= tolerance);
+    }
+
+    SUBCASE("Outside of the range the function is evaluated directly") {
+        HardSphere const func{0.01f};
+        vmcp::RadialTable<HardSphere> const table{func, 0.05f, 1};
+        for (vmcp::FPType r : {vmcp::FPType{0.02f}, vmcp::FPType{1}, vmcp::FPType{3}}) {
+            CHECK(table(r).u == func(r).u);
+            CHECK(table(r).uPrime == func(r).uPrime);
+            CHECK(table(r).uPrime2 == func(r).uPrime2);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+//!
+//! @file test-simdpack.cpp
+//! @brief Tests for the SIMD packs of the wrapper types
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+template <class L, class R>
+constexpr bool canAdd = requires(L l, R r) { l + r; };
+template <class L, class R>
+constexpr bool canMultiply = requires(L l, R r) { l * r; };
+
+} // namespace
+
+// The packs allow exactly the operations allowed by their wrapper types
+static_assert(canAdd<vmcp::CoordinatePack, vmcp::CoordinatePack>);
+static_assert(canAdd<vmcp::EnergyPack, vmcp::EnergyPack>);
+static_assert(!canAdd<vmcp::EnergyPack, vmcp::MassPack>);
+static_assert(!canAdd<vmcp::CoordinatePack, vmcp::VarParamPack>);
+static_assert(canMultiply<vmcp::CoordinatePack, vmcp::FPType>);
+static_assert(!canMultiply<vmcp::CoordinatePack, vmcp::CoordinatePack>);
+static_assert(!canMultiply<vmcp::MassPack, vmcp::EnergyPack>);
+static_assert(std::is_same_v<decltype(vmcp::EnergyPack{} * vmcp::EnergyPack{}), vmcp::EnSquaredPack>);
+
+TEST_CASE("Testing the SIMD packs") {
+    vmcp::RandomGenerator gen{seed};
+    std::uniform_real_distribution<vmcp::FPType> unif(-10, 10);
+
+    SUBCASE("Lane by lane operators") {
+        std::vector<vmcp::Energy> as(vmcp::simdLanes);
+        std::vector<vmcp::Energy> bs(vmcp::simdLanes);
+        for (vmcp::UIntType l = 0u; l != vmcp::simdLanes; ++l) {
+            as[l] = vmcp::Energy{unif(gen)};
+            bs[l] = vmcp::Energy{unif(gen)};
+        }
+        vmcp::EnergyPack const a = vmcp::EnergyPack::Load(as.data());
+        vmcp::EnergyPack const b = vmcp::EnergyPack::Load(bs.data());
+        CHECK((reinterpret_cast<std::uintptr_t>(&a) % vmcp::simdAlignment) == 0);
+
+        vmcp::EnergyPack const sum = a + b;
+        vmcp::EnergyPack const scaled = 2 * (a - b) / 4;
+        vmcp::EnSquaredPack const squared = a * a;
+        vmcp::PackMask const less = a < b;
+        vmcp::EnergyPack const smaller = vmcp::Select(less, a, b);
+        for (vmcp::UIntType l = 0u; l != vmcp::simdLanes; ++l) {
+            CHECK(sum[l].val == (as[l] + bs[l]).val);
+            CHECK(scaled[l].val == (2 * (as[l] - bs[l]) / 4).val);
+            CHECK(squared[l].val == (as[l] * as[l]).val);
+            CHECK(less[l] == (as[l] < bs[l]));
+            CHECK(smaller[l].val == (as[l] < bs[l] ? as[l] : bs[l]).val);
+        }
+
+        vmcp::Energy expected{0};
+        for (vmcp::Energy e : as) {
+            expected += e;
+        }
+        CHECK(vmcp::Sum(a).val == doctest::Approx(expected.val));
+
+        std::vector<vmcp::Energy> stored(vmcp::simdLanes);
+        sum.Store(stored.data());
+        for (vmcp::UIntType l = 0u; l != vmcp::simdLanes; ++l) {
+            CHECK(stored[l].val == sum.vals[l]);
+        }
+    }
+
+    SUBCASE("Loads and stores from the structure-of-arrays layout") {
+        constexpr vmcp::Dimension D = 2;
+        constexpr vmcp::ParticNum N = vmcp::simdLanes + 3;
+        vmcp::Positions<D, N> poss;
+        for (vmcp::Position<D> &p : poss) {
+            for (vmcp::Coordinate &c : p) {
+                c.val = unif(gen);
+            }
+        }
+        vmcp::SoAPositions<D, N> soaPoss{poss};
+        constexpr vmcp::ParticNum lastBlock = vmcp::SoAPositions<D, N>::paddedN - vmcp::simdLanes;
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            vmcp::CoordinatePack const first = vmcp::LoadPack(soaPoss, 0u, d);
+            for (vmcp::UIntType l = 0u; l != vmcp::simdLanes; ++l) {
+                CHECK(first[l].val == poss[l][d].val);
+            }
+            // Shifting the last block must leave its padding at zero
+            vmcp::CoordinatePack const shift = vmcp::CoordinatePack::Broadcast(vmcp::Coordinate{1});
+            vmcp::StorePack(soaPoss, lastBlock, d, vmcp::LoadPack(soaPoss, lastBlock, d) + shift);
+            for (vmcp::ParticNum n = lastBlock; n != vmcp::SoAPositions<D, N>::paddedN; ++n) {
+                if (n < N) {
+                    CHECK(soaPoss.Get(n, d).val == poss[n][d].val + 1);
+                } else {
+                    CHECK(soaPoss.Axis(d)[n] == vmcp::FPType{0});
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+//!
+//! @file test-stencil.cpp
+//! @brief Tests for the numeric estimators that displace the positions in place
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <cstring>
+
+namespace {
+
+constexpr vmcp::Dimension D = 3;
+constexpr vmcp::ParticNum N = 3;
+
+// Anisotropic gaussian times a pair factor, so that every coordinate matters and no derivative is trivial
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        vmcp::FPType pairTerm = 0;
+        for (vmcp::ParticNum i = 0u; i != N; ++i) {
+            for (vmcp::ParticNum j = i + 1u; j != N; ++j) {
+                pairTerm += (x[i][0].val - x[j][0].val) * (x[i][1].val - x[j][1].val);
+            }
+        }
+        vmcp::FPType const norm = vmcp::WeightedSquaredNorm<D, N>(x, {1, 2, 3});
+        return std::exp(-alpha[0].val * norm + pairTerm / 10);
+    }
+};
+struct Pot {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x) const {
+        return vmcp::WeightedSquaredNorm<D, N>(x, {1, 1, 1}) / 2;
+    }
+};
+
+// Reference stencils, which work on a displaced copy of the positions
+vmcp::FPType EvalOnCopy(Wavef const &wavef, vmcp::Positions<D, N> poss, vmcp::VarParams<1> params,
+                        vmcp::ParticNum n, vmcp::Dimension d, vmcp::FPType delta) {
+    poss[n][d].val += delta;
+    return wavef(poss, params);
+}
+
+vmcp::Energy LocalEnergyOnCopies(Wavef const &wavef, vmcp::VarParams<1> params, vmcp::FPType step,
+                                 vmcp::Masses<N> masses, Pot const &pot, vmcp::Positions<D, N> const &poss) {
+    constexpr std::array<vmcp::FPType, 9> coeffs{-1. / 560, 8. / 315, -1. / 5, 8. / 5, -205. / 72,
+                                                 8. / 5,    -1. / 5,  8. / 315, -1. / 560};
+    vmcp::FPType const psi = wavef(poss, params);
+    vmcp::Energy result{pot(poss)};
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            vmcp::FPType secondDerivative = coeffs[4] * psi;
+            for (vmcp::IntType k = -4; k != 5; ++k) {
+                if (k != 0) {
+                    vmcp::FPType const delta = static_cast<vmcp::FPType>(k) * step;
+                    secondDerivative += coeffs[static_cast<vmcp::UIntType>(k + 4)] *
+                                        EvalOnCopy(wavef, poss, params, n, d, delta);
+                }
+            }
+            result += vmcp::Energy{-vmcp::hbar * vmcp::hbar / (2 * masses[n].val) * secondDerivative /
+                                   (step * step * psi)};
+        }
+    }
+    return result;
+}
+
+vmcp::DriftForce<D, N> DriftForceOnCopies(Wavef const &wavef, vmcp::VarParams<1> params, vmcp::FPType step,
+                                          vmcp::Positions<D, N> const &poss) {
+    constexpr std::array<vmcp::FPType, 9> coeffs{1. / 280, -4. / 105, 1. / 5, -4. / 5, 0,
+                                                 4. / 5,   -1. / 5,   4. / 105, -1. / 280};
+    vmcp::FPType const psi = wavef(poss, params);
+    vmcp::DriftForce<D, N> result;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            vmcp::FPType derivative = 0;
+            for (vmcp::IntType k = -4; k != 5; ++k) {
+                if (k != 0) {
+                    vmcp::FPType const delta = static_cast<vmcp::FPType>(k) * step;
+                    derivative += coeffs[static_cast<vmcp::UIntType>(k + 4)] *
+                                  EvalOnCopy(wavef, poss, params, n, d, delta);
+                }
+            }
+            result[n][d] = 2 * derivative / (step * psi);
+        }
+    }
+    return result;
+}
+
+bool BitIdentical(vmcp::Positions<D, N> const &a, vmcp::Positions<D, N> const &b) {
+    return std::memcmp(a.data(), b.data(), sizeof(a)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Testing the in-place numeric stencils") {
+    constexpr vmcp::FPType stencilTolerance = 1e-10f;
+    // Not exactly representable, so that displacing and moving back would not restore the coordinates
+    constexpr vmcp::FPType step = 0.0137;
+
+    vmcp::RandomGenerator gen{seed};
+    std::uniform_real_distribution<vmcp::FPType> unif(-1, 1);
+    vmcp::Positions<D, N> poss;
+    for (vmcp::Position<D> &p : poss) {
+        for (vmcp::Coordinate &c : p) {
+            c.val = unif(gen);
+        }
+    }
+    vmcp::Positions<D, N> const original = poss;
+
+    Wavef const wavef;
+    Pot const pot;
+    vmcp::VarParams<1> const params{vmcp::VarParam{0.4f}};
+    vmcp::Masses<N> masses;
+    masses.fill(vmcp::Mass{1.5f});
+    vmcp::FPType const psi = wavef(poss, params);
+
+    SUBCASE("Single displacement") {
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                vmcp::FPType const displaced = vmcp::EvalDisplaced_<D, N>(
+                    poss, n, d, vmcp::Coordinate{step},
+                    [&wavef, params](vmcp::Positions<D, N> const &p) { return wavef(p, params); });
+                CHECK(BitIdentical(poss, original));
+                CHECK(displaced == EvalOnCopy(wavef, original, params, n, d, step));
+            }
+        }
+    }
+
+    SUBCASE("Local energy") {
+        vmcp::Energy const inPlace =
+            vmcp::LocalEnergyNumeric_<D, N, 1>(wavef, params, step, masses, pot(original), poss, psi);
+        CHECK(BitIdentical(poss, original));
+        vmcp::Energy const onCopies = LocalEnergyOnCopies(wavef, params, step, masses, pot, original);
+        CHECK(std::abs(inPlace.val - onCopies.val) < stencilTolerance * std::abs(onCopies.val));
+    }
+
+    SUBCASE("Drift force") {
+        vmcp::DriftForce<D, N> const inPlace =
+            vmcp::DriftForceNumeric_<D, N, 1>(wavef, poss, psi, params, step);
+        CHECK(BitIdentical(poss, original));
+        vmcp::DriftForce<D, N> const onCopies = DriftForceOnCopies(wavef, params, step, original);
+        for (vmcp::ParticNum n = 0u; n != N; ++n) {
+            for (vmcp::Dimension d = 0u; d != D; ++d) {
+                CHECK(std::abs(inPlace[n][d] - onCopies[n][d]) <
+                      stencilTolerance * (1 + std::abs(onCopies[n][d])));
+            }
+        }
+    }
+}
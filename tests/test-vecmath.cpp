@@ -0,0 +1,92 @@
+//!
+//! @file test-vecmath.cpp
+//! @brief Tests the accuracy of the vectorizable elementary functions against <cmath>
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+constexpr vmcp::IntType samples_vecMath = 1 << 16;
+
+bool WithinRelError(vmcp::FPType approx, vmcp::FPType exact, vmcp::FPType maxRelError) {
+    return std::abs(approx - exact) <= maxRelError * std::abs(exact);
+}
+
+} // namespace
+
+TEST_CASE("Testing the vectorizable elementary functions") {
+    vmcp::RandomGenerator gen{seed};
+
+    SUBCASE("Exponential") {
+        std::uniform_real_distribution<vmcp::FPType> unif(vmcp::minArg_fastExp, vmcp::maxArg_fastExp);
+        for (vmcp::IntType i = 0; i != samples_vecMath; ++i) {
+            vmcp::FPType const x = unif(gen);
+            CHECK(WithinRelError(vmcp::FastExp(x), std::exp(x), vmcp::maxRelError_fastExp));
+        }
+        std::uniform_real_distribution<vmcp::FPType> small(-1, 1);
+        for (vmcp::IntType i = 0; i != samples_vecMath; ++i) {
+            vmcp::FPType const x = small(gen);
+            CHECK(WithinRelError(vmcp::FastExp(x), std::exp(x), vmcp::maxRelError_fastExp));
+        }
+        CHECK(vmcp::FastExp(0) == 1);
+        CHECK(vmcp::FastExp(2 * vmcp::minArg_fastExp) == 0);
+        CHECK(vmcp::FastExp(2 * vmcp::maxArg_fastExp) == std::numeric_limits<vmcp::FPType>::infinity());
+    }
+
+    SUBCASE("Logarithm") {
+        // Spans the whole range of the normal numbers
+        std::uniform_real_distribution<vmcp::FPType> exponents(vmcp::minArg_fastExp, vmcp::maxArg_fastExp);
+        for (vmcp::IntType i = 0; i != samples_vecMath; ++i) {
+            vmcp::FPType const x = std::exp(exponents(gen));
+            CHECK(WithinRelError(vmcp::FastLog(x), std::log(x), vmcp::maxRelError_fastLog));
+        }
+        // Where the logarithm is close to zero
+        std::uniform_real_distribution<vmcp::FPType> nearOne(0.5f, 2);
+        for (vmcp::IntType i = 0; i != samples_vecMath; ++i) {
+            vmcp::FPType const x = nearOne(gen);
+            CHECK(WithinRelError(vmcp::FastLog(x), std::log(x), vmcp::maxRelError_fastLog));
+        }
+        CHECK(vmcp::FastLog(1) == 0);
+        CHECK(vmcp::FastLog(0) == -std::numeric_limits<vmcp::FPType>::infinity());
+    }
+
+    SUBCASE("Square root") {
+        std::uniform_real_distribution<vmcp::FPType> exponents(vmcp::minArg_fastExp, vmcp::maxArg_fastExp);
+        for (vmcp::IntType i = 0; i != samples_vecMath; ++i) {
+            vmcp::FPType const x = std::exp(exponents(gen));
+            CHECK(WithinRelError(vmcp::FastSqrt(x), std::sqrt(x), vmcp::maxRelError_fastSqrt));
+        }
+        CHECK(vmcp::FastSqrt(0) == 0);
+        CHECK(vmcp::FastSqrt(4) == 2);
+    }
+
+    SUBCASE("The batched versions match the scalar ones") {
+        std::array<vmcp::FPType, vmcp::simdLanes> xs;
+        std::uniform_real_distribution<vmcp::FPType> unif(0, 10);
+        for (vmcp::FPType &x : xs) {
+            x = unif(gen);
+        }
+        std::array<vmcp::FPType, vmcp::simdLanes> exps = xs;
+        std::array<vmcp::FPType, vmcp::simdLanes> logs = xs;
+        std::array<vmcp::FPType, vmcp::simdLanes> roots = xs;
+        vmcp::ExpInPlace(exps);
+        vmcp::LogInPlace(logs);
+        vmcp::SqrtInPlace(roots);
+        for (vmcp::UIntType l = 0u; l != vmcp::simdLanes; ++l) {
+            CHECK(exps[l] == vmcp::FastExp(xs[l]));
+            CHECK(logs[l] == vmcp::FastLog(xs[l]));
+            CHECK(roots[l] == vmcp::FastSqrt(xs[l]));
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//!
+//! @file test-walker.cpp
+//! @brief Tests for the quantities cached in the state of a walker
+//! @authors Lorenzo Fabbri, Francesco Orso Pancaldi
+//!
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "test.hpp"
+#include "vmcp.hpp"
+
+namespace {
+
+constexpr vmcp::Dimension D = 2;
+constexpr vmcp::ParticNum N = 3;
+
+struct Wavef {
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return std::exp(-alpha[0].val * vmcp::WeightedSquaredNorm<D, N>(x, {1, 1}));
+    }
+};
+struct FirstDer {
+    vmcp::Dimension dimension;
+    vmcp::ParticNum particle;
+    vmcp::FPType operator()(vmcp::Positions<D, N> const &x, vmcp::VarParams<1> alpha) const {
+        return -2 * alpha[0].val * x[particle][dimension].val * Wavef{}(x, alpha);
+    }
+};
+
+vmcp::Gradients<D, N, FirstDer> MakeGradients() {
+    vmcp::Gradients<D, N, FirstDer> grads;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        for (vmcp::Dimension d = 0u; d != D; ++d) {
+            grads[n][d] = FirstDer{d, n};
+        }
+    }
+    return grads;
+}
+
+// The cached values must be exactly the ones that a fresh evaluation at the same positions gives
+void CheckWalker(vmcp::WalkerState<D, N> const &walker, Wavef const &wavef, vmcp::VarParams<1> params,
+                 bool useAnalytical, vmcp::FPType derivativeStep,
+                 vmcp::Gradients<D, N, FirstDer> const &grads) {
+    CHECK(walker.psi == wavef(walker.positions, params));
+    if (walker.hasDriftForce) {
+        vmcp::Positions<D, N> poss = walker.positions;
+        vmcp::Scratch<D, N> scratch;
+        vmcp::DriftForce<D, N> const fresh = vmcp::DriftForce_<D, N, 1>(
+            wavef, poss, wavef(poss, params), params, useAnalytical, derivativeStep, grads, scratch);
+        CHECK(walker.driftForce == fresh);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Testing the walker state") {
+    // Enough updates for importance sampling, whose acceptance is close to one, to reject some moves
+    constexpr vmcp::IntType updates = 400;
+    constexpr vmcp::FPType derivativeStep = 1e-3f;
+
+    vmcp::RandomGenerator gen{seed};
+    Wavef const wavef;
+    vmcp::VarParams<1> const params{vmcp::VarParam{0.5f}};
+    vmcp::Gradients<D, N, FirstDer> const grads = MakeGradients();
+    vmcp::Masses<N> masses;
+    masses.fill(vmcp::Mass{1});
+    vmcp::Positions<D, N> startPoss;
+    for (vmcp::ParticNum n = 0u; n != N; ++n) {
+        startPoss[n] = {vmcp::Coordinate{static_cast<vmcp::FPType>(n) / 10}, vmcp::Coordinate{-0.2f}};
+    }
+
+    SUBCASE("Metropolis") {
+        vmcp::WalkerState<D, N> walker = vmcp::MakeWalkerState_<D, N, 1>(wavef, params, startPoss);
+        CHECK(!walker.hasDriftForce);
+        vmcp::IntType accepted = 0;
+        for (vmcp::IntType i = 0; i != updates; ++i) {
+            // A large step, so that both accepted and rejected moves happen
+            accepted += vmcp::MetropolisUpdate_<D, N, 1>(wavef, params, walker, 2, gen);
+            CheckWalker(walker, wavef, params, true, derivativeStep, grads);
+        }
+        CHECK(accepted > 0);
+        CHECK(accepted < updates * static_cast<vmcp::IntType>(N));
+    }
+
+    SUBCASE("Importance sampling") {
+        for (bool useAnalytical : {true, false}) {
+            CAPTURE(useAnalytical);
+            vmcp::WalkerState<D, N> walker = vmcp::MakeWalkerState_<D, N, 1>(wavef, params, startPoss);
+            vmcp::IntType accepted = 0;
+            for (vmcp::IntType i = 0; i != updates; ++i) {
+                accepted += vmcp::ImportanceSamplingUpdate_<D, N, 1>(
+                    wavef, params, useAnalytical, derivativeStep, grads, masses, walker, gen);
+                CHECK(walker.hasDriftForce);
+                CheckWalker(walker, wavef, params, useAnalytical, derivativeStep, grads);
+            }
+            CHECK(accepted > 0);
+            CHECK(accepted < updates * static_cast<vmcp::IntType>(N));
+        }
+    }
+}